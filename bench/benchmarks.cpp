@@ -0,0 +1,437 @@
+#include "store.h"
+
+// ==================== BENCHMARKS ====================
+// Micro-benchmarks, reported in the Google Benchmark JSON layout.
+const double MIN_BENCH_SECONDS = 0.2;
+
+template<typename T>
+inline void keepAlive(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class BenchmarkSuite {
+private:
+    struct Result {
+        string name;
+        unsigned long long iterations;
+        double nanosPerOp;
+    };
+
+    vector<Result> results;
+
+public:
+    template<typename Body>
+    void run(const string& name, Body body) {
+        unsigned long long iterations = 1;
+        double elapsed = 0.0;
+
+        for (;;) {
+            auto start = chrono::steady_clock::now();
+            body(iterations);
+            elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (elapsed >= MIN_BENCH_SECONDS || iterations >= (1ULL << 40)) break;
+
+            double scale = elapsed > 0.0 ? MIN_BENCH_SECONDS * 1.4 / elapsed : 100.0;
+            iterations = static_cast<unsigned long long>(static_cast<double>(iterations) * min(max(scale, 2.0), 100.0));
+        }
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.nanosPerOp = elapsed * 1e9 / static_cast<double>(iterations);
+        results.push_back(result);
+        cerr << left << setw(40) << name << right << setw(14) << fixed << setprecision(1)
+             << result.nanosPerOp << " ns/op" << setw(14) << iterations << " iterations\n";
+    }
+
+    void writeJson(ostream& out) const {
+        out << "{\n  \"context\": {\"executable\": \"store_bench\", \"num_cpus\": "
+            << thread::hardware_concurrency() << "},\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            out << "    {\"name\": ";
+            writeJsonString(out, results[i].name);
+            out << ", \"run_type\": \"iteration\", \"iterations\": " << results[i].iterations
+                << ", \"real_time\": " << fixed << setprecision(3) << results[i].nanosPerOp
+                << ", \"time_unit\": \"ns\"}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+};
+
+unique_ptr<ProductCatalog> makeBenchCatalog(int count) {
+    static const char* const brands[] = {"Acme", "Nova", "Zenith", "Orion", "Apex", "Lumen", "Vertex", "Pulse"};
+    static const char* const adjectives[] = {"Wireless", "Portable", "Gaming", "Compact", "Smart", "Ultra",
+                                             "Mini", "Pro", "Rugged", "Classic", "Slim", "Turbo"};
+    static const char* const nouns[] = {"Laptop", "Smartphone", "Headphones", "Keyboard", "Mouse", "Monitor",
+                                        "Tablet", "Speaker", "Power Bank", "Flash Drive", "Hard Drive", "Webcam",
+                                        "Router", "Charger", "Smartwatch", "Microphone", "Printer", "Projector",
+                                        "Camera", "Earbuds"};
+
+    unique_ptr<ProductCatalog> catalog(new ProductCatalog());
+    catalog->reserve(static_cast<size_t>(count));
+
+    const int alphabet = '~' - '!' + 1;
+    char code[PRODUCT_CODE_LENGTH + 1] = {0};
+    char name[MAX_PRODUCT_NAME_LENGTH];
+    for (int i = 0; catalog->getProductCount() < count && i < alphabet * alphabet * alphabet; i++) {
+        code[0] = static_cast<char>('!' + i / (alphabet * alphabet));
+        code[1] = static_cast<char>('!' + (i / alphabet) % alphabet);
+        code[2] = static_cast<char>('!' + i % alphabet);
+        if (catalog->getIndex().contains(code)) continue;
+        snprintf(name, sizeof(name), "%s %s %s %d", brands[i % 8], adjectives[i / 8 % 12],
+                 nouns[i / 96 % 20], i / 1920);
+        catalog->addProduct(Product(code, name, Money::fromCents(100 + i % 100000)));
+    }
+    return catalog;
+}
+
+ShoppingCart makeBenchCart(const ProductCatalog& catalog, int lines) {
+    ShoppingCart cart;
+    for (int i = 0; i < lines; i++) {
+        cart.addProduct(catalog.getProducts()[i % catalog.getProductCount()], 1 + i % 3);
+    }
+    return cart;
+}
+
+void runBenchmarks(ostream& out) {
+    BenchmarkSuite suite;
+    const int catalogSizes[] = {1000, 10000, 100000, 800000};
+    const int cartSizes[] = {1, 10, 100, 1000, 10000};
+    const size_t PROBES = 4096;
+
+    for (int size : catalogSizes) {
+        unique_ptr<ProductCatalog> catalog = makeBenchCatalog(size);
+        vector<string> probes;
+        unsigned int seed = 12345;
+        for (size_t i = 0; i < PROBES; i++) {
+            seed = seed * 1103515245u + 12345u;
+            probes.push_back(catalog->getProducts()[seed % static_cast<unsigned int>(catalog->getProductCount())].getId());
+        }
+        suite.run("findProductById/" + to_string(catalog->getProductCount()), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                keepAlive(catalog->findProductById(probes[i & (PROBES - 1)]));
+            }
+        });
+    }
+
+    unique_ptr<ProductCatalog> catalog = makeBenchCatalog(10000);
+    {
+        // Nine lookups in ten miss.
+        vector<string> probes;
+        vector<int> methods;
+        for (size_t i = 0; i < PROBES; i++) {
+            if (i % 10 == 0) {
+                probes.push_back(catalog->getProducts()[i % catalog->getProductCount()].getId());
+            } else {
+                probes.push_back(string("z") + static_cast<char>('!' + i % 90) + static_cast<char>('!' + i / 90 % 90));
+            }
+            methods.push_back(i % 10 == 0 ? 1 : 2 + static_cast<int>(i % 7));
+        }
+        suite.run("ProductCatalog::findProductById/miss90", [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                try {
+                    keepAlive(catalog->findProductById(probes[i & (PROBES - 1)]));
+                } catch (const ProductNotFoundException&) {
+                    keepAlive(i);
+                }
+            }
+        });
+        suite.run("ProductCatalog::lookupProduct/miss90", [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                Result<const Product*> product = catalog->lookupProduct(probes[i & (PROBES - 1)]);
+                keepAlive(product ? product.getValue() : nullptr);
+            }
+        });
+
+        PaymentRegistry payments;
+        payments.registerProvider(1, "💵", unique_ptr<PaymentStrategy>(new CashPayment()));
+        suite.run("PaymentRegistry::getMethodName/miss90", [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                try {
+                    keepAlive(payments.getMethodName(methods[i & (PROBES - 1)]));
+                } catch (const InvalidInputException&) {
+                    keepAlive(i);
+                }
+            }
+        });
+        suite.run("PaymentRegistry::lookupMethodName/miss90", [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                Result<const char*> method = payments.lookupMethodName(methods[i & (PROBES - 1)]);
+                keepAlive(method ? method.getValue() : nullptr);
+            }
+        });
+    }
+
+    for (int lines : cartSizes) {
+        suite.run("ShoppingCart::addProduct/merge/" + to_string(lines), [&](unsigned long long n) {
+            ShoppingCart cart = makeBenchCart(*catalog, lines);
+            for (unsigned long long i = 0; i < n; i++) {
+                if (i % 1000000 == 999999) cart = makeBenchCart(*catalog, lines);
+                cart.addProduct(catalog->getProducts()[i % static_cast<unsigned long long>(lines)], 1);
+            }
+            keepAlive(cart);
+        });
+    }
+
+    for (int lines : cartSizes) {
+        ShoppingCart cart = makeBenchCart(*catalog, lines);
+        suite.run("ShoppingCart::calculateTotal/" + to_string(lines), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                keepAlive(cart);
+                keepAlive(cart.calculateTotal());
+            }
+        });
+    }
+
+    for (int lines : cartSizes) {
+        vector<const char*> codes(lines);
+        vector<int> quantities(lines);
+        for (int i = 0; i < lines; i++) {
+            codes[i] = catalog->getProducts()[i % catalog->getProductCount()].getId();
+            quantities[i] = 1 + i % 3;
+        }
+        suite.run("ShoppingCart::addProducts/" + to_string(lines), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                ShoppingCart cart;
+                cart.addProducts(*catalog, codes.data(), quantities.data(), codes.size());
+                keepAlive(cart);
+            }
+        });
+    }
+
+    {
+        unique_ptr<ProductCatalog> large = makeBenchCatalog(800000);
+        ProductSearchIndex index;
+        index.rebuild(*large);
+        const char* queries[] = {"wireless speaker", "blutooth hedphones", "lap", "acme pro webcam 17", "projektor"};
+        suite.run("ProductSearchIndex::search/" + to_string(large->getProductCount()), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                keepAlive(index.search(queries[i % 5], SEARCH_RESULT_LIMIT));
+            }
+        });
+        vector<uint32_t> changed(1, ProductIndex::packCode(large->getProducts()[0].getId()));
+        suite.run("ProductSearchIndex::apply/rename", [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                index.apply(changed, *large);
+            }
+        });
+    }
+
+    {
+        PromotionEngine promotions;
+        for (int i = 0; i < catalog->getProductCount(); i++) {
+            Promotion promotion;
+            promotion.codes.push_back(catalog->getProducts()[i].getId());
+            promotion.basisPoints = 500 + i % 1000;
+            if (i % 2 == 1) {
+                promotion.type = PromotionType::VolumeTier;
+                promotion.minQuantity = 2;
+            } else if (i % 3 == 2) {
+                promotion.type = PromotionType::Bundle;
+                promotion.codes.push_back(catalog->getProducts()[i - 1].getId());
+                promotion.amount = Money::fromUnits(10);
+            }
+            promotions.add(promotion);
+        }
+        for (int lines : cartSizes) {
+            ShoppingCart cart = makeBenchCart(*catalog, lines);
+            suite.run("PromotionEngine::price/" + to_string(lines), [&](unsigned long long n) {
+                for (unsigned long long i = 0; i < n; i++) {
+                    keepAlive(promotions.price(cart, "GCash"));
+                }
+            });
+        }
+    }
+
+    {
+        Inventory inventory;
+        inventory.setStock("LAP", 1000000);
+        uint32_t key = ProductIndex::packCode("LAP");
+        suite.run("Inventory::reserve+release", [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                keepAlive(inventory.reserve(key, 1));
+                inventory.release(key, 1);
+            }
+        });
+    }
+
+    {
+        MockGatewayConfig gatewayConfig;
+        gatewayConfig.latencyMicros = 200;
+        PaymentRegistry payments;
+        payments.registerProvider(1, "", unique_ptr<PaymentStrategy>(new CardPayment()),
+                                  make_shared<MockPaymentGateway>(gatewayConfig));
+        int nextKey = 1;
+        for (size_t depth : {1, 16}) {
+            suite.run("PaymentRegistry::authorize/inflight/" + to_string(depth), [&](unsigned long long n) {
+                deque<future<PaymentResult>> inflight;
+                for (unsigned long long i = 0; i < n; i++) {
+                    if (inflight.size() >= depth) {
+                        keepAlive(inflight.front().get());
+                        inflight.pop_front();
+                    }
+                    inflight.push_back(payments.authorize(1, Money::fromUnits(100), nextKey++));
+                }
+                while (!inflight.empty()) {
+                    keepAlive(inflight.front().get());
+                    inflight.pop_front();
+                }
+            });
+        }
+    }
+
+    {
+        ShoppingCart cart = makeBenchCart(*catalog, 10);
+        string records;
+        suite.run("CartStore::encodeCart/10", [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                if (i % 10000 == 0) records.clear();
+                CartStore::encodeCart("session-0000042", cart, records);
+            }
+        });
+
+        const int SESSIONS = 100000;
+        string path = (filesystem::temp_directory_path() / "onlineStore-bench.carts").string();
+        filesystem::remove(path);
+        {
+            CartStore store(path);
+            store.recover([](string_view, const CartItem*, size_t) {});
+            records.clear();
+            for (int i = 0; i < SESSIONS; i++) {
+                CartStore::encodeCart("session-" + to_string(i), cart, records);
+            }
+            store.save(records, SESSIONS);
+        }
+        suite.run("CartStore::recover/" + to_string(SESSIONS), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                unordered_map<string, ShoppingCart> sessions;
+                CartStore store(path);
+                store.recover([&sessions](string_view session, const CartItem* lines, size_t count) {
+                    sessions.try_emplace(string(session)).first->second.restore(lines, count);
+                });
+                keepAlive(sessions.size());
+            }
+        });
+        filesystem::remove(path);
+    }
+
+    CashPayment payment;
+    for (int lines : cartSizes) {
+        ShoppingCart cart = makeBenchCart(*catalog, lines);
+        suite.run("Order::Order/" + to_string(lines), [&](unsigned long long n) {
+            unique_ptr<OrderArena> arena(new OrderArena());
+            for (unsigned long long i = 0; i < n; i++) {
+                if (i % 10000 == 9999) arena.reset(new OrderArena());
+                Order order(static_cast<int>(i), cart, &payment, CartPricing(cart.calculateTotal()), *arena);
+                keepAlive(order);
+            }
+        });
+    }
+
+    for (int lines : {10, 1000}) {
+        ShoppingCart cart = makeBenchCart(*catalog, lines);
+        OrderArena arena;
+        Order order(1, cart, &payment, CartPricing(cart.calculateTotal()), arena);
+        RenderBuffer screen;
+        suite.run("Order::display/" + to_string(lines), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                order.display(screen, *catalog);
+                keepAlive(screen.size());
+                screen.clear();
+            }
+        });
+    }
+
+    {
+        const int ORDERS = 1000000;
+        const long long START = 1700000000;
+        OrderStore store(16);
+        JournalOrder recovered;
+        recovered.total = Money::fromCents(1000);
+        recovered.paymentMethod = "Cash";
+        recovered.lines.resize(1);
+        memcpy(recovered.lines[0].code, "LAP", sizeof(recovered.lines[0].code));
+        recovered.lines[0].quantity = 1;
+        recovered.lines[0].unitPrice = recovered.total;
+        for (int i = 0; i < ORDERS; i++) {
+            recovered.orderId = i + 1;
+            recovered.placedAt = START + static_cast<long long>(i) * 31;
+            store.restore(recovered);
+        }
+        suite.run("OrderStore::find/" + to_string(ORDERS), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                keepAlive(store.find(static_cast<int>(i * 7919 % ORDERS) + 1));
+            }
+        });
+        suite.run("OrderStore::findBetween/" + to_string(ORDERS), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                long long from = START + static_cast<long long>(i % 300) * 86400;
+                keepAlive(store.findBetween(from, from + 3600).size());
+            }
+        });
+    }
+
+    {
+        const int ORDERS = 1000000;
+        const long long START = 1700000000;
+        SalesAnalytics analytics;
+        OrderLine line;
+        memcpy(line.code, "LAP", sizeof(line.code));
+        for (int i = 0; i < ORDERS; i++) {
+            line.quantity = 1 + i % 3;
+            line.unitPrice = Money::fromCents(1000 + i % 500);
+            Order order(i + 1, &line, 1, line.unitPrice * line.quantity,
+                        START + static_cast<long long>(i) * 31, i % 2 ? "Cash" : "GCash");
+            analytics.record(order);
+        }
+        long long end = START + static_cast<long long>(ORDERS) * 31;
+        suite.run("SalesAnalytics::salesBetween/" + to_string(ORDERS), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                keepAlive(analytics.salesBetween(START + static_cast<long long>(i % 1000) * 3600, end));
+            }
+        });
+        suite.run("SalesAnalytics::scanBetween/" + to_string(ORDERS), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                keepAlive(analytics.scanBetween(START + static_cast<long long>(i % 1000) * 3600, end));
+            }
+        });
+    }
+
+    const char* logPath = "bench_orders.log";
+    for (int async = 0; async <= 1; async++) {
+        LoggerConfig config;
+        config.path = logPath;
+        config.async = async == 1;
+        OrderLogger::shutdown();
+        OrderLogger::configure(config);
+        OrderLogger* logger = OrderLogger::getInstance();
+
+        suite.run(string("OrderLogger::logOrder/") + (async ? "async" : "sync"), [&](unsigned long long n) {
+            for (unsigned long long i = 0; i < n; i++) {
+                logger->logOrder(static_cast<int>(i), "Credit/Debit Card");
+            }
+        });
+        OrderLogger::shutdown();
+    }
+    remove(logPath);
+
+    suite.writeJson(out);
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc > 1) {
+            ofstream report(argv[1]);
+            if (!report.is_open()) {
+                throw runtime_error("Failed to create benchmark report.");
+            }
+            runBenchmarks(report);
+        } else {
+            runBenchmarks(cout);
+        }
+    } catch (const exception& e) {
+        cerr << "Benchmark failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,489 @@
+#include "cart.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// ==================== SHOPPING CART ====================
+// Callers rule out overflow before using it.
+static uint64_t sumLineCents(const uint32_t* prices, const uint32_t* quantities, size_t count) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#ifdef __SSE2__
+    // _mm_mul_epu32 multiplies lanes 0 and 2; shifting by 32 brings up lanes 1 and 3.
+    __m128i evenSums = _mm_setzero_si128();
+    __m128i oddSums = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i price = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prices + i));
+        __m128i quantity = _mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities + i));
+        evenSums = _mm_add_epi64(evenSums, _mm_mul_epu32(price, quantity));
+        oddSums = _mm_add_epi64(oddSums, _mm_mul_epu32(_mm_srli_epi64(price, 32), _mm_srli_epi64(quantity, 32)));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(evenSums, oddSums));
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < count; i++) {
+        sum += static_cast<uint64_t>(prices[i]) * quantities[i];
+    }
+    return sum;
+}
+
+bool ShoppingCart::holdStock(uint32_t key, int quantity) {
+    if (inventory == nullptr || !inventory->reserve(key, quantity)) return false;
+
+    int slot = holdIndex.find(key);
+    if (slot < 0) {
+        holdIndex.insert(key, static_cast<int>(holds.size()));
+        holds.push_back(make_pair(key, quantity));
+    } else {
+        holds[slot].second += quantity;
+    }
+    lastReservedAt = steadySeconds();
+    return true;
+}
+
+void ShoppingCart::releaseStock() {
+    if (inventory != nullptr) {
+        for (const pair<uint32_t, int>& hold : holds) {
+            if (hold.second > 0) inventory->release(hold.first, hold.second);
+        }
+    }
+    holds.clear();
+    holdIndex.clear();
+}
+
+void ShoppingCart::addProduct(const Product& product, int quantity) {
+    STORE_METRIC_SCOPE(METRIC_CART_ADD);
+    if (quantity <= 0) {
+        throw invalid_argument("Quantity must be positive");
+    }
+
+    Money newTotal = total + product.getPrice() * quantity;
+    uint32_t key = ProductIndex::packCode(product.getId());
+    int slot = lineIndex.find(key);
+
+    // Lines merge only at the same unit price.
+    bool merge = slot >= 0 && items[slot].getUnitPrice() == product.getPrice();
+    if (merge && items[slot].getQuantity() > INT_MAX - quantity) {
+        throw overflow_error("Quantity would exceed maximum value");
+    }
+    holdStock(key, quantity);
+
+    if (merge) {
+        items[slot].setQuantity(items[slot].getQuantity() + quantity);
+    } else {
+        lineIndex.insert(key, static_cast<int>(items.size()));
+        items.push_back(CartItem(product, quantity));
+    }
+    total = newTotal;
+    checkoutOrderId = 0;
+    changed = true;
+}
+
+StoreError ShoppingCart::tryAddProducts(const ProductCatalog& catalog, const char* const* codes, const int* quantities, size_t count) {
+    vector<int> slots(count);
+    vector<uint32_t> prices(count);
+    vector<uint32_t> amounts(count);
+    bool narrowPrices = true;
+    long long maxPrice = 0;
+    long long quantitySum = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (quantities[i] <= 0) {
+            throw invalid_argument("Quantity must be positive");
+        }
+        slots[i] = catalog.getIndex().find(ProductIndex::packCode(codes[i]));
+        if (slots[i] < 0) {
+            return StoreError::ProductNotFound;
+        }
+        long long price = catalog.getProducts()[slots[i]].getPrice().getCents();
+        narrowPrices = narrowPrices && price >= 0 && price <= static_cast<long long>(UINT32_MAX);
+        prices[i] = static_cast<uint32_t>(price);
+        amounts[i] = static_cast<uint32_t>(quantities[i]);
+        maxPrice = max(maxPrice, price < 0 ? -price : price);
+        quantitySum += quantities[i];
+    }
+
+    // Checked Money arithmetic unless the 32-bit columns cannot overflow.
+    long long bound;
+    Money batchTotal;
+    if (narrowPrices && !__builtin_mul_overflow(maxPrice, quantitySum, &bound)) {
+        batchTotal = Money::fromCents(static_cast<long long>(sumLineCents(prices.data(), amounts.data(), count)));
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            batchTotal += catalog.getProducts()[slots[i]].getPrice() * quantities[i];
+        }
+    }
+    Money newTotal = total + batchTotal;
+
+    size_t firstNewLine = items.size();
+    vector<pair<int, int>> mergedLines;
+    vector<pair<uint32_t, int>> replacedIndex;
+    vector<pair<uint32_t, int>> newHolds;
+    try {
+        for (size_t i = 0; i < count; i++) {
+            const Product& product = catalog.getProducts()[slots[i]];
+            uint32_t key = ProductIndex::packCode(product.getId());
+            int slot = lineIndex.find(key);
+
+            bool merge = slot >= 0 && items[slot].getUnitPrice() == product.getPrice();
+            if (merge && items[slot].getQuantity() > INT_MAX - quantities[i]) {
+                throw overflow_error("Quantity would exceed maximum value");
+            }
+            if (holdStock(key, quantities[i])) {
+                newHolds.push_back(make_pair(key, quantities[i]));
+            }
+
+            if (merge) {
+                if (static_cast<size_t>(slot) < firstNewLine) {
+                    mergedLines.push_back(make_pair(slot, items[slot].getQuantity()));
+                }
+                items[slot].setQuantity(items[slot].getQuantity() + quantities[i]);
+            } else {
+                replacedIndex.push_back(make_pair(key, slot));
+                lineIndex.insert(key, static_cast<int>(items.size()));
+                items.push_back(CartItem(product, quantities[i]));
+            }
+        }
+    } catch (...) {
+        for (const pair<uint32_t, int>& hold : newHolds) {
+            dropHold(hold.first, hold.second);
+        }
+        for (size_t i = replacedIndex.size(); i-- > 0;) {
+            if (replacedIndex[i].second < 0) {
+                lineIndex.erase(replacedIndex[i].first);
+            } else {
+                lineIndex.insert(replacedIndex[i].first, replacedIndex[i].second);
+            }
+        }
+        for (size_t i = mergedLines.size(); i-- > 0;) {
+            items[mergedLines[i].first].setQuantity(mergedLines[i].second);
+        }
+        items.resize(firstNewLine);
+        throw;
+    }
+    total = newTotal;
+    checkoutOrderId = 0;
+    changed = true;
+    return StoreError::None;
+}
+
+void ShoppingCart::restore(const CartItem* lines, size_t count) {
+    clear();
+    changed = false;
+    items.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const char* code = lines[i].getCode();
+        uint32_t key = ProductIndex::packCode(string_view(code, strnlen(code, PRODUCT_CODE_LENGTH + 1)));
+        if (key == 0 || lines[i].getQuantity() <= 0) {
+            changed = true;
+            continue;
+        }
+        Money newTotal;
+        try {
+            newTotal = total + lines[i].getUnitPrice() * lines[i].getQuantity();
+            holdStock(key, lines[i].getQuantity());
+        } catch (const exception&) {
+            changed = true;
+            continue;
+        }
+        lineIndex.insert(key, static_cast<int>(items.size()));
+        items.push_back(lines[i]);
+        total = newTotal;
+    }
+}
+
+void ShoppingCart::commitStock() {
+    if (inventory != nullptr) {
+        for (const pair<uint32_t, int>& hold : holds) {
+            if (hold.second > 0) inventory->commit(hold.first, hold.second);
+        }
+    }
+    holds.clear();
+    holdIndex.clear();
+}
+
+void ShoppingCart::display(RenderBuffer& screen, const ProductCatalog& catalog) const {
+    if (items.empty()) {
+        throw EmptyCartException();
+    }
+
+    renderPaged(screen, items.size(), PAGE_ROWS,
+        [](RenderBuffer& page) {
+            page.add("╔══════════╦══════════════════════╦════════════╦══════════╗\n"
+                     "║   ID     ║        Name          ║   Price    ║  Qty     ║\n"
+                     "╠══════════╬══════════════════════╬════════════╬══════════╣\n");
+        },
+        [this, &catalog](RenderBuffer& page, size_t i) {
+            int slot = catalog.getIndex().find(ProductIndex::packCode(items[i].getCode()));
+            items[i].display(page, slot >= 0 ? catalog.getProducts()[slot].getName() : "Unknown product");
+        },
+        [this](RenderBuffer& page, bool last) {
+            if (!last) {
+                page.add("╚══════════╩══════════════════════╩════════════╩══════════╝\n");
+                return;
+            }
+            page.add("╠════════════════════════════════╬════════════╬══════════╣\n"
+                     "║            TOTAL               ║ ").right(total, 10).add(" ║          ║\n"
+                     "╚════════════════════════════════╩════════════╩══════════╝\n");
+        });
+}
+
+void ShoppingCart::clear() {
+    releaseStock();
+    items.clear();
+    lineIndex.clear();
+    total = Money();
+    checkoutOrderId = 0;
+    changed = true;
+}
+
+// ==================== PROMOTIONS ====================
+const char* promotionTypeName(PromotionType type) {
+    switch (type) {
+        case PromotionType::PercentOff: return "percent";
+        case PromotionType::VolumeTier: return "tier";
+        case PromotionType::Bundle: return "bundle";
+        case PromotionType::PaymentMethod: return "method";
+    }
+    return "unknown";
+}
+
+void CartPricing::note(int promotionId) {
+    for (int i = 0; i < promotionCount; i++) {
+        if (promotionIds[i] == promotionId) return;
+    }
+    if (promotionCount < MAX_APPLIED_PROMOTIONS) {
+        promotionIds[promotionCount++] = promotionId;
+    }
+}
+
+void PromotionEngine::dropSkuPlan(uint32_t key) {
+    int slot = planSlots.find(key);
+    if (slot < 0) return;
+    planSlots.erase(key);
+    if (static_cast<size_t>(slot) + 1 != skuPlans.size()) {
+        skuPlans[slot] = move(skuPlans.back());
+        planSlots.insert(skuPlans[slot].key, slot);
+    }
+    skuPlans.pop_back();
+}
+
+void PromotionEngine::compileSku(uint32_t key) {
+    unordered_map<uint32_t, vector<int>>::const_iterator ids = promotionsBySku.find(key);
+    if (ids == promotionsBySku.end()) {
+        dropSkuPlan(key);
+        return;
+    }
+
+    SkuPlan plan = SkuPlan();
+    plan.key = key;
+    for (int id : ids->second) {
+        const Promotion& promotion = promotions.at(id);
+        if (promotion.type == PromotionType::PercentOff && promotion.basisPoints > plan.basisPoints) {
+            plan.basisPoints = promotion.basisPoints;
+            plan.promotionId = id;
+        } else if (promotion.type == PromotionType::VolumeTier) {
+            plan.tiers.push_back(Tier{promotion.minQuantity, promotion.basisPoints, id});
+        } else if (promotion.type == PromotionType::Bundle) {
+            plan.bundles.push_back(id);
+        }
+    }
+    sort(plan.tiers.begin(), plan.tiers.end(), [](const Tier& a, const Tier& b) {
+        return a.minQuantity < b.minQuantity;
+    });
+    for (size_t i = 1; i < plan.tiers.size(); i++) {
+        if (plan.tiers[i].basisPoints < plan.tiers[i - 1].basisPoints) {
+            plan.tiers[i].basisPoints = plan.tiers[i - 1].basisPoints;
+            plan.tiers[i].promotionId = plan.tiers[i - 1].promotionId;
+        }
+    }
+
+    int slot = planSlots.find(key);
+    if (slot < 0) {
+        slot = static_cast<int>(skuPlans.size());
+        skuPlans.emplace_back();
+        planSlots.insert(key, slot);
+    }
+    skuPlans[slot] = move(plan);
+}
+
+void PromotionEngine::compileMethod(const string& method) {
+    MethodPlan plan = {0, 0};
+    for (const pair<const int, Promotion>& entry : promotions) {
+        const Promotion& promotion = entry.second;
+        if (promotion.type == PromotionType::PaymentMethod && promotion.method == method &&
+            promotion.basisPoints > plan.basisPoints) {
+            plan.basisPoints = promotion.basisPoints;
+            plan.promotionId = promotion.id;
+        }
+    }
+    if (plan.promotionId == 0) {
+        methodPlans.erase(method);
+    } else {
+        methodPlans[method] = plan;
+    }
+}
+
+void PromotionEngine::compile(const Promotion& promotion) {
+    if (promotion.type == PromotionType::PaymentMethod) {
+        compileMethod(promotion.method);
+        return;
+    }
+    for (const string& code : promotion.codes) {
+        compileSku(ProductIndex::packCode(code));
+    }
+}
+
+void PromotionEngine::validate(const Promotion& promotion) {
+    bool usesRate = promotion.type != PromotionType::Bundle;
+    if (usesRate && (promotion.basisPoints <= 0 || promotion.basisPoints > 10000)) {
+        throw invalid_argument("Percent must be above 0 and at most 100");
+    }
+    if (promotion.type == PromotionType::PaymentMethod) {
+        if (promotion.method.empty()) throw invalid_argument("Payment method is required");
+        return;
+    }
+
+    size_t wanted = promotion.type == PromotionType::Bundle ? 2 : 1;
+    if (promotion.codes.size() < wanted || promotion.codes.size() > (wanted == 1 ? 1 : MAX_BUNDLE_PRODUCTS)) {
+        throw invalid_argument(wanted == 1 ? "Exactly one product code is required"
+                                           : "A bundle needs 2 to 4 product codes");
+    }
+    for (size_t i = 0; i < promotion.codes.size(); i++) {
+        if (ProductIndex::packCode(promotion.codes[i]) == 0) {
+            throw invalid_argument("Product code must be exactly 3 characters");
+        }
+        if (find(promotion.codes.begin(), promotion.codes.begin() + i, promotion.codes[i]) != promotion.codes.begin() + i) {
+            throw invalid_argument("Bundle product codes must be distinct");
+        }
+    }
+    if (promotion.type == PromotionType::VolumeTier && promotion.minQuantity < 1) {
+        throw invalid_argument("Minimum quantity must be at least 1");
+    }
+    if (promotion.type == PromotionType::Bundle && promotion.amount.getCents() <= 0) {
+        throw invalid_argument("Bundle discount must be positive");
+    }
+}
+
+int PromotionEngine::add(Promotion promotion) {
+    validate(promotion);
+
+    unique_lock<shared_mutex> guard(lock);
+    promotion.id = nextPromotionId++;
+    const Promotion& stored = promotions.emplace(promotion.id, move(promotion)).first->second;
+    if (stored.type == PromotionType::Bundle) {
+        BundlePlan bundle;
+        for (const string& code : stored.codes) {
+            bundle.keys.push_back(ProductIndex::packCode(code));
+        }
+        bundle.amount = stored.amount;
+        bundlePlans[stored.id] = bundle;
+    }
+    for (const string& code : stored.codes) {
+        promotionsBySku[ProductIndex::packCode(code)].push_back(stored.id);
+    }
+    compile(stored);
+    return stored.id;
+}
+
+bool PromotionEngine::remove(int id) {
+    unique_lock<shared_mutex> guard(lock);
+    map<int, Promotion>::iterator it = promotions.find(id);
+    if (it == promotions.end()) return false;
+
+    Promotion removed = move(it->second);
+    promotions.erase(it);
+    bundlePlans.erase(id);
+    for (const string& code : removed.codes) {
+        unordered_map<uint32_t, vector<int>>::iterator ids = promotionsBySku.find(ProductIndex::packCode(code));
+        if (ids == promotionsBySku.end()) continue;
+        ids->second.erase(std::remove(ids->second.begin(), ids->second.end(), id), ids->second.end());
+        if (ids->second.empty()) {
+            promotionsBySku.erase(ids);
+        }
+    }
+    compile(removed);
+    return true;
+}
+
+vector<Promotion> PromotionEngine::list() const {
+    shared_lock<shared_mutex> guard(lock);
+    vector<Promotion> all;
+    for (const pair<const int, Promotion>& entry : promotions) {
+        all.push_back(entry.second);
+    }
+    return all;
+}
+
+CartPricing PromotionEngine::price(const ShoppingCart& cart, const string& method) const {
+    CartPricing pricing(cart.calculateTotal());
+    const CartItem* items = cart.getItems();
+    int lineCount = cart.getItemCount();
+
+    shared_lock<shared_mutex> guard(lock);
+    if (promotions.empty()) return pricing;
+
+    ProductIndex quantities;
+    vector<int> bundles;
+    for (int i = 0; i < lineCount; i++) {
+        uint32_t key = ProductIndex::packCode(items[i].getCode());
+        int slot = planSlots.find(key);
+        if (slot < 0 || !skuPlans[slot].needsQuantity()) continue;
+        int earlier = quantities.find(key);
+        quantities.insert(key, (earlier < 0 ? 0 : earlier) + items[i].getQuantity());
+        bundles.insert(bundles.end(), skuPlans[slot].bundles.begin(), skuPlans[slot].bundles.end());
+    }
+
+    Money discount;
+    for (int i = 0; i < lineCount; i++) {
+        uint32_t key = ProductIndex::packCode(items[i].getCode());
+        int slot = planSlots.find(key);
+        if (slot < 0) continue;
+        const SkuPlan& plan = skuPlans[slot];
+
+        int basisPoints = plan.basisPoints;
+        int promotionId = plan.promotionId;
+        if (!plan.tiers.empty()) {
+            int quantity = quantities.find(key);
+            vector<Tier>::const_iterator reached = upper_bound(plan.tiers.begin(), plan.tiers.end(), quantity,
+                [](int value, const Tier& tier) { return value < tier.minQuantity; });
+            if (reached != plan.tiers.begin() && (reached - 1)->basisPoints > basisPoints) {
+                basisPoints = (reached - 1)->basisPoints;
+                promotionId = (reached - 1)->promotionId;
+            }
+        }
+        if (basisPoints > 0) {
+            discount += (items[i].getUnitPrice() * items[i].getQuantity()).percent(basisPoints);
+            pricing.note(promotionId);
+        }
+    }
+
+    sort(bundles.begin(), bundles.end());
+    bundles.erase(unique(bundles.begin(), bundles.end()), bundles.end());
+    for (int id : bundles) {
+        const BundlePlan& bundle = bundlePlans.at(id);
+        int sets = INT_MAX;
+        for (uint32_t key : bundle.keys) {
+            sets = min(sets, max(quantities.find(key), 0));
+        }
+        if (sets > 0) {
+            discount += bundle.amount * sets;
+            pricing.note(id);
+        }
+    }
+    discount = min(discount, pricing.subtotal);
+
+    unordered_map<string, MethodPlan>::const_iterator byMethod = methodPlans.find(method);
+    if (byMethod != methodPlans.end()) {
+        Money methodDiscount = (pricing.subtotal - discount).percent(byMethod->second.basisPoints);
+        if (methodDiscount.getCents() > 0) {
+            discount += methodDiscount;
+            pricing.note(byMethod->second.promotionId);
+        }
+    }
+
+    pricing.discount = discount;
+    return pricing;
+}
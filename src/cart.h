@@ -0,0 +1,206 @@
+#ifndef STORE_CART_H
+#define STORE_CART_H
+
+#include "catalog.h"
+
+// ==================== SHOPPING CART ====================
+// Sum of prices[i] * quantities[i]; callers rule out overflow.
+
+// Cart lines in insertion order, indexed by product code, with a running total.
+class ShoppingCart {
+private:
+    vector<CartItem> items;
+    ProductIndex lineIndex;
+    Money total;
+    int checkoutOrderId = 0;
+    bool changed = false;
+    bool paymentPending = false;
+
+    Inventory* inventory;
+    vector<pair<uint32_t, int>> holds;
+    ProductIndex holdIndex;
+    long long lastReservedAt = 0;
+
+    bool holdStock(uint32_t key, int quantity);
+
+    void dropHold(uint32_t key, int quantity) {
+        inventory->release(key, quantity);
+        holds[holdIndex.find(key)].second -= quantity;
+    }
+
+    void releaseStock();
+
+public:
+    explicit ShoppingCart(Inventory* inventory = nullptr) : inventory(inventory) {}
+
+    ShoppingCart(const ShoppingCart&) = delete;
+    ShoppingCart& operator=(const ShoppingCart&) = delete;
+
+    ShoppingCart(ShoppingCart&& other) noexcept : inventory(nullptr) {
+        *this = move(other);
+    }
+
+    ShoppingCart& operator=(ShoppingCart&& other) noexcept {
+        if (this != &other) {
+            releaseStock();
+            items = move(other.items);
+            lineIndex = move(other.lineIndex);
+            total = other.total;
+            checkoutOrderId = other.checkoutOrderId;
+            changed = other.changed;
+            paymentPending = other.paymentPending;
+            inventory = other.inventory;
+            holds = move(other.holds);
+            holdIndex = move(other.holdIndex);
+            lastReservedAt = other.lastReservedAt;
+
+            other.items.clear();
+            other.lineIndex = ProductIndex();
+            other.total = Money();
+            other.checkoutOrderId = 0;
+            other.changed = false;
+            other.paymentPending = false;
+            other.holds.clear();
+            other.holdIndex = ProductIndex();
+        }
+        return *this;
+    }
+
+    ~ShoppingCart() {
+        releaseStock();
+    }
+
+    int getItemCount() const { return static_cast<int>(items.size()); }
+    const CartItem* getItems() const { return items.data(); }
+    bool hasReservations() const { return !holds.empty(); }
+    long long getLastReservedAt() const { return lastReservedAt; }
+    bool hasChanges() const { return changed; }
+    void markSaved() { changed = false; }
+    bool isPaymentPending() const { return paymentPending; }
+    void setPaymentPending(bool pending) { paymentPending = pending; }
+
+    // Reused by a retried payment so the gateway sees the same idempotency key.
+    int getCheckoutOrderId() const { return checkoutOrderId; }
+    void setCheckoutOrderId(int orderId) { checkoutOrderId = orderId; }
+
+    void addProduct(const Product& product, int quantity = 1);
+
+    // Adds many lines at once, all or nothing.
+    StoreError tryAddProducts(const ProductCatalog& catalog, const char* const* codes, const int* quantities, size_t count);
+
+    void addProducts(const ProductCatalog& catalog, const char* const* codes, const int* quantities, size_t count) {
+        StoreError error = tryAddProducts(catalog, codes, quantities, count);
+        if (error != StoreError::None) {
+            throwStoreError(error);
+        }
+    }
+
+    // Refills an empty cart with saved lines, reserving stock again.
+    void restore(const CartItem* lines, size_t count);
+
+    Money calculateTotal() const {
+        return total;
+    }
+
+    void commitStock();
+    void display(RenderBuffer& screen, const ProductCatalog& catalog) const;
+    void clear();
+};
+
+// ==================== PROMOTIONS ====================
+const int MAX_APPLIED_PROMOTIONS = 8;
+const int MAX_BUNDLE_PRODUCTS = 4;
+
+enum class PromotionType {
+    PercentOff,     // basisPoints off one product
+    VolumeTier,     // basisPoints off one product once minQuantity are bought
+    Bundle,         // amount off per complete set of 2-4 products
+    PaymentMethod   // basisPoints off the order when paid with method
+};
+
+const char* promotionTypeName(PromotionType type);
+
+// Rates are in basis points: 1250 is 12.5% off.
+struct Promotion {
+    int id;
+    PromotionType type;
+    vector<string> codes;
+    int minQuantity;
+    int basisPoints;
+    Money amount;
+    string method;
+
+    Promotion() : id(0), type(PromotionType::PercentOff), minQuantity(1), basisPoints(0) {}
+};
+
+struct CartPricing {
+    Money subtotal;
+    Money discount;
+    int promotionCount;
+    int promotionIds[MAX_APPLIED_PROMOTIONS];
+
+    explicit CartPricing(Money subtotal = Money()) : subtotal(subtotal), promotionCount(0) {}
+
+    Money getTotal() const { return subtotal - discount; }
+
+    void note(int promotionId);
+};
+
+// Active promotions compiled into a plan keyed by product code and payment method.
+class PromotionEngine {
+private:
+    struct Tier {
+        int minQuantity;
+        int basisPoints;
+        int promotionId;
+    };
+
+    // Tiers are sorted by minQuantity.
+    struct SkuPlan {
+        uint32_t key;
+        int basisPoints;
+        int promotionId;
+        vector<Tier> tiers;
+        vector<int> bundles;
+
+        bool needsQuantity() const { return !tiers.empty() || !bundles.empty(); }
+    };
+
+    struct BundlePlan {
+        vector<uint32_t> keys;
+        Money amount;
+    };
+
+    struct MethodPlan {
+        int basisPoints;
+        int promotionId;
+    };
+
+    map<int, Promotion> promotions;
+    unordered_map<uint32_t, vector<int>> promotionsBySku;
+    ProductIndex planSlots;
+    vector<SkuPlan> skuPlans;
+    unordered_map<int, BundlePlan> bundlePlans;
+    unordered_map<string, MethodPlan> methodPlans;
+    int nextPromotionId;
+    mutable shared_mutex lock;
+
+    void dropSkuPlan(uint32_t key);
+    void compileSku(uint32_t key);
+    void compileMethod(const string& method);
+    void compile(const Promotion& promotion);
+    static void validate(const Promotion& promotion);
+
+public:
+    PromotionEngine() : nextPromotionId(1) {}
+
+    PromotionEngine(const PromotionEngine&) = delete;
+    PromotionEngine& operator=(const PromotionEngine&) = delete;
+
+    int add(Promotion promotion);
+    bool remove(int id);
+    vector<Promotion> list() const;
+    CartPricing price(const ShoppingCart& cart, const string& method) const;
+};
+
+#endif
@@ -0,0 +1,612 @@
+#include "catalog.h"
+
+// ==================== PRODUCT INDEX ====================
+void ProductIndex::rehash(size_t capacity) {
+    vector<uint32_t> oldKeys(capacity, 0);
+    vector<int> oldSlots(capacity, -1);
+    oldKeys.swap(keys);
+    oldSlots.swap(slots);
+    mask = capacity - 1;
+
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldKeys[i] != 0) {
+            size_t b = bucketFor(oldKeys[i], mask);
+            while (keys[b] != 0) {
+                b = (b + 1) & mask;
+            }
+            keys[b] = oldKeys[i];
+            slots[b] = oldSlots[i];
+        }
+    }
+}
+
+void ProductIndex::reserve(size_t entries) {
+    size_t capacity = keys.size();
+    while (capacity < entries * 2) {
+        capacity *= 2;
+    }
+    if (capacity != keys.size()) {
+        rehash(capacity);
+    }
+}
+
+bool ProductIndex::erase(uint32_t key) {
+    if (key == 0) return false;
+    size_t hole = bucketFor(key, mask);
+    while (keys[hole] != key) {
+        if (keys[hole] == 0) return false;
+        hole = (hole + 1) & mask;
+    }
+
+    size_t next = hole;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (keys[next] == 0) break;
+        size_t home = bucketFor(keys[next], mask);
+        bool staysPut = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!staysPut) {
+            keys[hole] = keys[next];
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    keys[hole] = 0;
+    slots[hole] = -1;
+    count--;
+    return true;
+}
+
+// ==================== CATALOG FILES ====================
+void MappedFile::open(const string& path) {
+    close();
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        throw runtime_error("Failed to open catalog file.");
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        close();
+        throw runtime_error("Failed to read catalog file size.");
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) return;
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        close();
+        throw runtime_error("Failed to map catalog file.");
+    }
+    data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        close();
+        throw runtime_error("Failed to map catalog file.");
+    }
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Failed to open catalog file.");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        throw runtime_error("Failed to read catalog file size.");
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size == 0) return;
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        throw runtime_error("Failed to map catalog file.");
+    }
+    data = static_cast<const char*>(mapped);
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (data != nullptr) munmap(const_cast<char*>(data), size);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+void splitCsvLine(string_view line, vector<string>& fields) {
+    fields.clear();
+    string field;
+    bool quoted = false;
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else if (c != '\r') {
+            field += c;
+        }
+    }
+    fields.push_back(field);
+}
+
+size_t convertCatalogCsv(const string& csvPath, const string& binaryPath) {
+    ifstream csv(csvPath);
+    if (!csv.is_open()) {
+        throw runtime_error("Failed to open CSV catalog.");
+    }
+
+    vector<Product> records;
+    ProductIndex seen;
+    vector<string> fields;
+    string line;
+    int lineNumber = 0;
+
+    while (getline(csv, line)) {
+        lineNumber++;
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+
+        splitCsvLine(line, fields);
+        if (lineNumber == 1 && !fields.empty() && fields[0] == "code") continue;
+
+        Money price;
+        if (fields.size() != 3 || fields[0].length() != PRODUCT_CODE_LENGTH ||
+            fields[1].length() >= MAX_PRODUCT_NAME_LENGTH || !Money::parse(fields[2], price)) {
+            throw runtime_error("Malformed CSV catalog at line " + to_string(lineNumber) + ".");
+        }
+
+        for (char& c : fields[0]) {
+            c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+            if ((c < 'A' || c > 'Z') && (c < '0' || c > '9')) {
+                throw runtime_error("Invalid product code at line " + to_string(lineNumber) + ".");
+            }
+        }
+
+        uint32_t key = ProductIndex::packCode(fields[0]);
+        if (seen.find(key) >= 0) {
+            throw runtime_error("Duplicate product code at line " + to_string(lineNumber) + ".");
+        }
+        seen.insert(key, static_cast<int>(records.size()));
+        records.push_back(Product(fields[0].c_str(), fields[1].c_str(), price));
+    }
+
+    CatalogFileHeader header;
+    memcpy(header.magic, CATALOG_FILE_MAGIC, sizeof(header.magic));
+    header.version = CATALOG_FILE_VERSION;
+    header.productCount = records.size();
+
+    ofstream binary(binaryPath, ios::binary | ios::trunc);
+    if (!binary.is_open()) {
+        throw runtime_error("Failed to create binary catalog.");
+    }
+    binary.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    binary.write(reinterpret_cast<const char*>(records.data()),
+                 static_cast<streamsize>(records.size() * sizeof(Product)));
+    if (!binary) {
+        throw runtime_error("Failed to write binary catalog.");
+    }
+    return records.size();
+}
+
+// ==================== PRODUCT CATALOG ====================
+void ProductCatalog::detachMapping() {
+    if (mappedProducts != nullptr) {
+        products.assign(mappedProducts, mappedProducts + mappedCount);
+        mappedProducts = nullptr;
+        mappedCount = 0;
+        mapping.reset();
+    }
+}
+
+ProductCatalog::ProductCatalog() : mappedProducts(nullptr), mappedCount(0), version(1) {
+    // Original products
+    addProduct(Product("LAP", "Laptop", Money::fromUnits(5000)));
+    addProduct(Product("PHN", "Smartphone", Money::fromUnits(2000)));
+    addProduct(Product("HDP", "Headphones", Money::fromUnits(3000)));
+    addProduct(Product("KEY", "Keyboard", Money::fromUnits(1500)));
+    addProduct(Product("MOU", "Mouse", Money::fromUnits(800)));
+    addProduct(Product("MON", "Monitor", Money::fromUnits(1200)));
+    addProduct(Product("TAB", "Tablet", Money::fromUnits(1500)));
+    addProduct(Product("SPK", "Bluetooth Speaker", Money::fromUnits(250)));
+    addProduct(Product("POW", "Power Bank", Money::fromUnits(1800)));
+    addProduct(Product("USB", "USB Flash Drive", Money::fromUnits(500)));
+    addProduct(Product("HDD", "External Hard Drive", Money::fromUnits(4000)));
+    nameChanges.clear();
+}
+
+void ProductCatalog::loadBinary(const string& path) {
+    shared_ptr<MappedFile> file = make_shared<MappedFile>();
+    file->open(path);
+
+    if (file->getSize() < sizeof(CatalogFileHeader)) {
+        throw runtime_error("Catalog file is truncated.");
+    }
+    CatalogFileHeader header;
+    memcpy(&header, file->getData(), sizeof(header));
+    if (memcmp(header.magic, CATALOG_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CATALOG_FILE_VERSION) {
+        throw runtime_error("Unsupported catalog file format.");
+    }
+    if (header.productCount > (file->getSize() - sizeof(header)) / sizeof(Product) ||
+        file->getSize() != sizeof(header) + header.productCount * sizeof(Product)) {
+        throw runtime_error("Catalog file size does not match its header.");
+    }
+
+    const Product* records = reinterpret_cast<const Product*>(file->getData() + sizeof(header));
+    size_t count = static_cast<size_t>(header.productCount);
+
+    ProductIndex newIndex;
+    newIndex.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t key = ProductIndex::packCode(records[i].getId());
+        if (!records[i].isWellFormed() || key == 0 || newIndex.find(key) >= 0) {
+            throw runtime_error("Catalog file contains an invalid record.");
+        }
+        newIndex.insert(key, static_cast<int>(i));
+    }
+
+    products.clear();
+    products.shrink_to_fit();
+    mapping = file;
+    mappedProducts = records;
+    mappedCount = count;
+    index = newIndex;
+}
+
+void ProductCatalog::addProduct(const Product& product) {
+    uint32_t key = ProductIndex::packCode(product.getId());
+    if (key == 0) {
+        throw invalid_argument("Product code must be exactly 3 characters");
+    }
+    if (index.find(key) >= 0) {
+        throw invalid_argument("Duplicate product code");
+    }
+    detachMapping();
+    index.insert(key, static_cast<int>(products.size()));
+    products.push_back(product);
+    nameChanges.push_back(key);
+}
+
+void ProductCatalog::renameProduct(const string& id, const char* name) {
+    if (strlen(name) >= MAX_PRODUCT_NAME_LENGTH) {
+        throw invalid_argument("Product name is too long");
+    }
+    detachMapping();
+    products[findSlot(id)].setName(name);
+    nameChanges.push_back(ProductIndex::packCode(id));
+}
+
+void ProductCatalog::removeProduct(const string& id) {
+    int slot = findSlot(id);
+    detachMapping();
+
+    size_t last = products.size() - 1;
+    index.erase(ProductIndex::packCode(id));
+    if (static_cast<size_t>(slot) != last) {
+        products[slot] = products[last];
+        index.insert(ProductIndex::packCode(products[slot].getId()), slot);
+    }
+    products.pop_back();
+    nameChanges.push_back(ProductIndex::packCode(id));
+}
+
+Result<int> ProductCatalog::lookupSlot(string_view id) const {
+    int slot = index.find(ProductIndex::packCode(id));
+    if (slot < 0) {
+        return StoreError::ProductNotFound;
+    }
+    return slot;
+}
+
+Result<const Product*> ProductCatalog::lookupProduct(string_view id) const {
+    STORE_METRIC_SCOPE(METRIC_FIND_PRODUCT);
+    Result<int> slot = lookupSlot(id);
+    if (!slot) {
+        return slot.getError();
+    }
+    return &getProducts()[slot.getValue()];
+}
+
+void ProductCatalog::displayProducts(RenderBuffer& screen) const {
+    const Product* all = getProducts();
+    renderPaged(screen, static_cast<size_t>(getProductCount()), PAGE_ROWS,
+        [](RenderBuffer& page) {
+            page.add("╔══════════╦══════════════════════╦════════════╗\n"
+                     "║   ID     ║        Name          ║   Price    ║\n"
+                     "╠══════════╬══════════════════════╬════════════╣\n");
+        },
+        [all](RenderBuffer& page, size_t i) { all[i].display(page); },
+        [](RenderBuffer& page, bool) {
+            page.add("╚══════════╩══════════════════════╩════════════╝\n");
+        });
+}
+
+// ==================== PRODUCT SEARCH ====================
+int ProductSearchIndex::symbolOf(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    if (u >= 'a' && u <= 'z') return u - 'a' + 1;
+    if (u >= 'A' && u <= 'Z') return u - 'A' + 1;
+    if (u >= '0' && u <= '9') return u - '0' + 27;
+    return -1;
+}
+
+void ProductSearchIndex::retire(uint32_t key) {
+    int document = documentByKey.find(key);
+    if (document >= 0) {
+        documents[document].live = false;
+        documentByKey.erase(key);
+        retired++;
+    }
+}
+
+void ProductSearchIndex::append(const Product& product) {
+    uint32_t key = ProductIndex::packCode(product.getId());
+    uint32_t document = static_cast<uint32_t>(documents.size());
+    string_view name(product.getName());
+    documents.push_back(Document{key, static_cast<uint8_t>(name.size()), true});
+    documentByKey.insert(key, static_cast<int>(document));
+    forEachTrigram(name, [&](uint32_t trigram) {
+        vector<uint32_t>& list = postings[trigram];
+        if (!list.empty() && list.back() == document) return;
+        list.push_back(document);
+
+        vector<uint64_t>& bits = denseBits[trigram];
+        if (bits.empty()) {
+            if (list.size() < MIN_DENSE_POSTINGS || list.size() * 32 < documents.size()) return;
+            for (uint32_t earlier : list) {
+                setBit(bits, earlier);
+            }
+        } else {
+            setBit(bits, document);
+        }
+    });
+}
+
+bool ProductSearchIndex::hasTrigram(uint32_t trigram, uint32_t document) const {
+    const vector<uint64_t>& bits = denseBits[trigram];
+    if (!bits.empty()) {
+        return document / 64 < bits.size() && (bits[document / 64] >> (document % 64) & 1) != 0;
+    }
+    const vector<uint32_t>& list = postings[trigram];
+    return binary_search(list.begin(), list.end(), document);
+}
+
+void ProductSearchIndex::rebuildLocked(const ProductCatalog& catalog) {
+    for (vector<uint32_t>& list : postings) {
+        list.clear();
+    }
+    for (vector<uint64_t>& bits : denseBits) {
+        bits.clear();
+    }
+    documents.clear();
+    documentByKey = ProductIndex();
+    documentByKey.reserve(static_cast<size_t>(catalog.getProductCount()));
+    retired = 0;
+
+    const Product* all = catalog.getProducts();
+    for (int i = 0; i < catalog.getProductCount(); i++) {
+        append(all[i]);
+    }
+}
+
+void ProductSearchIndex::collectFullMatches(const vector<uint32_t>& trigrams, vector<uint32_t>& matches) const {
+    bool allDense = true;
+    size_t words = documents.size() / 64 + 1;
+    for (uint32_t trigram : trigrams) {
+        allDense = allDense && !denseBits[trigram].empty();
+        words = min(words, denseBits[trigram].size());
+    }
+
+    if (allDense) {
+        for (size_t w = 0; w < words; w++) {
+            uint64_t mask = ~0ULL;
+            for (size_t i = 0; i < trigrams.size() && mask != 0; i++) {
+                mask &= denseBits[trigrams[i]][w];
+            }
+            while (mask != 0) {
+                uint32_t document = static_cast<uint32_t>(w * 64 + __builtin_ctzll(mask));
+                if (documents[document].live) matches.push_back(document);
+                mask &= mask - 1;
+            }
+        }
+        return;
+    }
+
+    for (uint32_t document : postings[trigrams[0]]) {
+        if (!documents[document].live) continue;
+        size_t i = 1;
+        while (i < trigrams.size() && hasTrigram(trigrams[i], document)) {
+            i++;
+        }
+        if (i == trigrams.size()) matches.push_back(document);
+    }
+}
+
+void ProductSearchIndex::collectPartialMatches(const vector<uint32_t>& trigrams, size_t minScore, vector<uint8_t>& scores,
+                                               vector<uint32_t>& touched, vector<uint32_t>& matches) const {
+    size_t scanned = trigrams.size() - minScore + 1;
+    for (size_t i = 0; i < scanned; i++) {
+        for (uint32_t document : postings[trigrams[i]]) {
+            if (scores[document]++ == 0) {
+                touched.push_back(document);
+            }
+        }
+    }
+
+    for (uint32_t document : touched) {
+        if (!documents[document].live) continue;
+        for (size_t i = scanned; i < trigrams.size(); i++) {
+            if (hasTrigram(trigrams[i], document)) {
+                scores[document]++;
+            }
+        }
+        if (scores[document] >= minScore) {
+            matches.push_back(document);
+        }
+    }
+}
+
+void ProductSearchIndex::apply(const vector<uint32_t>& changedKeys, const ProductCatalog& catalog) {
+    unique_lock<shared_mutex> guard(lock);
+    for (uint32_t key : changedKeys) {
+        retire(key);
+        int slot = catalog.getIndex().find(key);
+        if (slot >= 0) {
+            append(catalog.getProducts()[slot]);
+        }
+    }
+    if (retired > documents.size() - retired) {
+        rebuildLocked(catalog);
+    }
+}
+
+vector<SearchHit> ProductSearchIndex::search(string_view query, size_t limit) const {
+    vector<uint32_t> trigrams;
+    forEachTrigram(query, [&](uint32_t trigram) { trigrams.push_back(trigram); });
+    sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    if (trigrams.size() > MAX_QUERY_TRIGRAMS) {
+        trigrams.resize(MAX_QUERY_TRIGRAMS);
+    }
+
+    vector<SearchHit> hits;
+    if (trigrams.empty() || limit == 0) return hits;
+
+    thread_local vector<uint8_t> scores;
+    thread_local vector<uint32_t> touched;
+
+    shared_lock<shared_mutex> guard(lock);
+    sort(trigrams.begin(), trigrams.end(), [this](uint32_t a, uint32_t b) {
+        return postings[a].size() < postings[b].size();
+    });
+
+    vector<uint32_t> matches;
+    bool fullMatches = false;
+    if (postings[trigrams[0]].size() >= limit) {
+        collectFullMatches(trigrams, matches);
+        fullMatches = matches.size() >= limit;
+    }
+    if (!fullMatches) {
+        matches.clear();
+        if (scores.size() < documents.size()) {
+            scores.resize(documents.size(), 0);
+        }
+        collectPartialMatches(trigrams, (trigrams.size() + 1) / 2, scores, touched, matches);
+    }
+
+    auto scoreOf = [&](uint32_t document) {
+        return fullMatches ? static_cast<int>(trigrams.size()) : static_cast<int>(scores[document]);
+    };
+    auto better = [&](uint32_t a, uint32_t b) {
+        if (scoreOf(a) != scoreOf(b)) return scoreOf(a) > scoreOf(b);
+        if (documents[a].nameLength != documents[b].nameLength) {
+            return documents[a].nameLength < documents[b].nameLength;
+        }
+        return documents[a].key < documents[b].key;
+    };
+    size_t count = min(limit, matches.size());
+    partial_sort(matches.begin(), matches.begin() + count, matches.end(), better);
+
+    for (size_t i = 0; i < count; i++) {
+        SearchHit hit;
+        uint32_t key = documents[matches[i]].key;
+        hit.code[0] = static_cast<char>(key >> 16);
+        hit.code[1] = static_cast<char>(key >> 8);
+        hit.code[2] = static_cast<char>(key);
+        hit.code[3] = '\0';
+        hit.score = scoreOf(matches[i]);
+        hits.push_back(hit);
+    }
+
+    for (uint32_t document : touched) {
+        scores[document] = 0;
+    }
+    touched.clear();
+    return hits;
+}
+
+// ==================== INVENTORY ====================
+long long steadySeconds() {
+    return chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Inventory::setStock(string_view code, int onHand) {
+    uint32_t key = ProductIndex::packCode(code);
+    if (key == 0 || onHand < 0) {
+        throw invalid_argument("Invalid stock update");
+    }
+    StockCell& cell = cellFor(key);
+    uint64_t current = cell.counts.load(memory_order_relaxed);
+    while (!cell.counts.compare_exchange_weak(current, pack(onHand, reservedOf(current)), memory_order_acq_rel)) {}
+    cell.tracked.store(true, memory_order_release);
+}
+
+StockLevel Inventory::getLevel(string_view code) const {
+    StockLevel level = {false, 0, 0};
+    StockCell* cell = findCell(ProductIndex::packCode(code));
+    if (cell != nullptr && cell->tracked.load(memory_order_acquire)) {
+        uint64_t counts = cell->counts.load(memory_order_acquire);
+        level.tracked = true;
+        level.onHand = onHandOf(counts);
+        level.reserved = reservedOf(counts);
+    }
+    return level;
+}
+
+// ==================== CATALOG HANDLE ====================
+ReadEpochs::ReaderSlot ReadEpochs::slots[ReadEpochs::MAX_READERS];
+atomic<uint64_t> ReadEpochs::globalEpoch(1);
+
+void ReadEpochs::synchronize() {
+    uint64_t target = globalEpoch.fetch_add(1) + 1;
+    for (int i = 0; i < MAX_READERS; i++) {
+        for (;;) {
+            uint64_t epoch = slots[i].epoch.load();
+            if (epoch == 0 || epoch >= target) break;
+            this_thread::yield();
+        }
+    }
+}
+
+void CatalogHandle::update(const function<void(ProductCatalog&)>& mutate) {
+    auto start = chrono::steady_clock::now();
+    lock_guard<mutex> guard(writerLock);
+    const ProductCatalog* base = current.load();
+    unique_ptr<ProductCatalog> next(new ProductCatalog(*base));
+    mutate(*next);
+    next->setVersion(base->getVersion() + 1);
+    swapIn(move(next), start);
+}
+
+void CatalogHandle::swapIn(unique_ptr<ProductCatalog> next, chrono::steady_clock::time_point start) {
+    const ProductCatalog* old = current.exchange(next.release());
+    auto published = chrono::steady_clock::now();
+    ReadEpochs::synchronize();
+    auto reclaimed = chrono::steady_clock::now();
+    delete old;
+
+    long long latency = chrono::duration_cast<chrono::microseconds>(published - start).count();
+    long long graceWait = chrono::duration_cast<chrono::microseconds>(reclaimed - published).count();
+    stats.updates++;
+    stats.lastUpdateMicros = latency;
+    stats.maxUpdateMicros = max(stats.maxUpdateMicros, latency);
+    stats.lastGraceWaitMicros = graceWait;
+    stats.maxGraceWaitMicros = max(stats.maxGraceWaitMicros, graceWait);
+}
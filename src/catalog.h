@@ -0,0 +1,632 @@
+#ifndef STORE_CATALOG_H
+#define STORE_CATALOG_H
+
+#include "money.h"
+#include "console.h"
+
+// ==================== PRODUCT INDEX ====================
+// Linear-probing hash index from a packed product code to its catalog slot.
+class ProductIndex {
+private:
+    vector<uint32_t> keys;
+    vector<int> slots;
+    size_t count;
+    size_t mask;
+
+    static size_t bucketFor(uint32_t key, size_t mask) {
+        uint32_t h = key * 2654435761u;
+        h ^= h >> 16;
+        return h & mask;
+    }
+
+    void rehash(size_t capacity);
+
+public:
+    ProductIndex() : keys(16, 0), slots(16, -1), count(0), mask(15) {}
+
+    static uint32_t packCode(const char* code) {
+        if (strlen(code) != PRODUCT_CODE_LENGTH) {
+            return 0;
+        }
+        return (static_cast<uint32_t>(static_cast<unsigned char>(code[0])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(code[1])) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(code[2]));
+    }
+
+    static uint32_t packCode(string_view code) {
+        if (code.length() != PRODUCT_CODE_LENGTH) {
+            return 0;
+        }
+        return (static_cast<uint32_t>(static_cast<unsigned char>(code[0])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(code[1])) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(code[2]));
+    }
+
+    void reserve(size_t entries);
+
+    void insert(uint32_t key, int slot) {
+        if ((count + 1) * 2 > keys.size()) {
+            rehash(keys.size() * 2);
+        }
+        size_t b = bucketFor(key, mask);
+        while (keys[b] != 0 && keys[b] != key) {
+            b = (b + 1) & mask;
+        }
+        if (keys[b] == 0) {
+            keys[b] = key;
+            count++;
+        }
+        slots[b] = slot;
+    }
+
+    int find(uint32_t key) const {
+        if (key == 0) return -1;
+        size_t b = bucketFor(key, mask);
+        while (keys[b] != 0) {
+            if (keys[b] == key) return slots[b];
+            b = (b + 1) & mask;
+        }
+        return -1;
+    }
+
+    bool contains(string_view code) const {
+        return find(packCode(code)) >= 0;
+    }
+
+    // Backward-shift deletion, so no tombstones are left.
+    bool erase(uint32_t key);
+
+    void clear() {
+        fill(keys.begin(), keys.end(), 0);
+        fill(slots.begin(), slots.end(), -1);
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+};
+
+// ==================== PRODUCT CLASS ====================
+// Fixed 64-byte record, the same layout as the binary catalog file.
+class Product {
+private:
+    char id[PRODUCT_CODE_LENGTH + 1];
+    char name[MAX_PRODUCT_NAME_LENGTH];
+    char reserved[2];
+    Money price;
+
+public:
+    Product() {
+        memset(id, 0, sizeof(id));
+        memset(name, 0, sizeof(name));
+        memset(reserved, 0, sizeof(reserved));
+    }
+
+    Product(const char* id, const char* name, Money price) : Product() {
+        memcpy(this->id, id, strnlen(id, PRODUCT_CODE_LENGTH));
+        memcpy(this->name, name, strnlen(name, MAX_PRODUCT_NAME_LENGTH - 1));
+        this->price = price;
+    }
+
+    const char* getId() const { return id; }
+    const char* getName() const { return name; }
+    Money getPrice() const { return price; }
+
+    void setName(const char* newName) {
+        memset(name, 0, sizeof(name));
+        memcpy(name, newName, strnlen(newName, MAX_PRODUCT_NAME_LENGTH - 1));
+    }
+
+    void setPrice(Money newPrice) { price = newPrice; }
+
+    // Checks a record read from an untrusted file before it is served.
+    bool isWellFormed() const {
+        return id[PRODUCT_CODE_LENGTH] == '\0' &&
+               name[MAX_PRODUCT_NAME_LENGTH - 1] == '\0' &&
+               price.getCents() >= 0;
+    }
+
+    void display(RenderBuffer& screen) const {
+        screen.add("║ ").left(id, 8).add(" ║ ").left(name, 20).add(" ║ ").right(price, 10).add(" ║\n");
+    }
+};
+
+static_assert(sizeof(Product) == 64, "Product must match the binary catalog record size");
+static_assert(is_trivially_copyable<Money>::value, "Money must be trivially copyable");
+static_assert(is_trivially_copyable<Product>::value, "Product must be trivially copyable");
+
+// ==================== CART ITEM CLASS ====================
+// Compact cart line: code, quantity and the unit price when added.
+class CartItem {
+private:
+    char code[PRODUCT_CODE_LENGTH + 1];
+    int quantity;
+    Money unitPrice;
+
+public:
+    CartItem() : quantity(0) {
+        memset(code, 0, sizeof(code));
+    }
+
+    CartItem(const Product& p, int qty) : quantity(qty), unitPrice(p.getPrice()) {
+        memcpy(code, p.getId(), sizeof(code));
+    }
+
+    const char* getCode() const { return code; }
+    int getQuantity() const { return quantity; }
+    Money getUnitPrice() const { return unitPrice; }
+    void setQuantity(int qty) { quantity = qty; }
+
+    void display(RenderBuffer& screen, const char* name) const {
+        screen.add("║ ").left(code, 8).add(" ║ ").left(name, 20).add(" ║ ")
+              .right(unitPrice, 10).add(" ║ ").right(quantity, 8).add(" ║\n");
+    }
+};
+
+static_assert(sizeof(CartItem) == 16, "CartItem is expected to stay 16 bytes");
+
+// ==================== CATALOG FILES ====================
+// Read-only memory mapping of a whole file.
+class MappedFile {
+private:
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+#ifdef _WIN32
+    MappedFile() : data(nullptr), size(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {}
+#else
+    MappedFile() : data(nullptr), size(0), fd(-1) {}
+#endif
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    void open(const string& path);
+    void close();
+
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+struct CatalogFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t productCount;
+};
+
+const char CATALOG_FILE_MAGIC[4] = {'O', 'S', 'C', 'T'};
+const uint32_t CATALOG_FILE_VERSION = 1;
+
+static_assert(sizeof(CatalogFileHeader) == 16, "Catalog header must stay 16 bytes");
+
+// Splits one CSV line, honouring quotes and "" escapes.
+void splitCsvLine(string_view line, vector<string>& fields);
+
+// Converts a "code,name,price" CSV file into the binary catalog format.
+// Codes are uppercased and must then be letters and digits only.
+size_t convertCatalogCsv(const string& csvPath, const string& binaryPath);
+
+// ==================== PRODUCT CATALOG ====================
+class ProductCatalog {
+private:
+    vector<Product> products;
+    shared_ptr<MappedFile> mapping;
+    const Product* mappedProducts;
+    size_t mappedCount;
+    ProductIndex index;
+    unsigned long long version;
+    vector<uint32_t> nameChanges;
+
+    void detachMapping();
+
+public:
+    ProductCatalog();
+
+    // Serves the records of a binary catalog file straight from the mapping.
+    void loadBinary(const string& path);
+
+    void reserve(size_t productCount) {
+        detachMapping();
+        products.reserve(productCount);
+        index.reserve(productCount);
+    }
+
+    void addProduct(const Product& product);
+
+    void setPrice(const string& id, Money price) {
+        detachMapping();
+        products[findSlot(id)].setPrice(price);
+    }
+
+    void renameProduct(const string& id, const char* name);
+    void removeProduct(const string& id);
+    Result<int> lookupSlot(string_view id) const;
+
+    int findSlot(string_view id) const {
+        return lookupSlot(id).valueOrThrow();
+    }
+
+    unsigned long long getVersion() const { return version; }
+    void setVersion(unsigned long long newVersion) { version = newVersion; }
+
+    // Codes changed since the last clear, for the search index.
+    const vector<uint32_t>& getNameChanges() const { return nameChanges; }
+    void clearNameChanges() { nameChanges.clear(); }
+
+    const Product* getProducts() const {
+        return mappedProducts != nullptr ? mappedProducts : products.data();
+    }
+
+    int getProductCount() const {
+        return static_cast<int>(mappedProducts != nullptr ? mappedCount : products.size());
+    }
+
+    const ProductIndex& getIndex() const { return index; }
+
+    Result<const Product*> lookupProduct(string_view id) const;
+
+    const Product& findProductById(string_view id) const {
+        return *lookupProduct(id).valueOrThrow();
+    }
+
+    void displayProducts(RenderBuffer& screen) const;
+};
+
+// ==================== PRODUCT SEARCH ====================
+struct SearchHit {
+    char code[PRODUCT_CODE_LENGTH + 1];
+    int score;
+};
+
+// Trigram index over product names; a product matches when it shares half the query's trigrams.
+class ProductSearchIndex {
+private:
+    struct Document {
+        uint32_t key;
+        uint8_t nameLength;
+        bool live;
+    };
+
+    static const int ALPHABET = 37;
+    static const int TRIGRAM_COUNT = ALPHABET * ALPHABET * ALPHABET;
+    static const size_t MAX_QUERY_TRIGRAMS = 64;
+    static const size_t MIN_DENSE_POSTINGS = 1024;
+
+    vector<vector<uint32_t>> postings;
+    vector<vector<uint64_t>> denseBits;
+    vector<Document> documents;
+    ProductIndex documentByKey;
+    size_t retired;
+    mutable shared_mutex lock;
+
+    static int symbolOf(char c);
+
+    template <typename Visit>
+    static void forEachTrigram(string_view text, Visit visit) {
+        int previous2 = -1;
+        int previous1 = 0;
+        for (size_t i = 0; i <= text.size(); i++) {
+            int symbol = i < text.size() ? symbolOf(text[i]) : -1;
+            if (symbol < 0) {
+                previous2 = -1;
+                previous1 = 0;
+                continue;
+            }
+            if (previous2 >= 0) {
+                visit(static_cast<uint32_t>((previous2 * ALPHABET + previous1) * ALPHABET + symbol));
+            }
+            previous2 = previous1;
+            previous1 = symbol;
+        }
+    }
+
+    void retire(uint32_t key);
+    void append(const Product& product);
+
+    static void setBit(vector<uint64_t>& bits, uint32_t document) {
+        if (document / 64 >= bits.size()) {
+            bits.resize(max(bits.size() * 2, static_cast<size_t>(document / 64 + 1)), 0);
+        }
+        bits[document / 64] |= 1ULL << (document % 64);
+    }
+
+    bool hasTrigram(uint32_t trigram, uint32_t document) const;
+    void rebuildLocked(const ProductCatalog& catalog);
+
+    // Live documents containing every trigram.
+    void collectFullMatches(const vector<uint32_t>& trigrams, vector<uint32_t>& matches) const;
+
+    // Live documents sharing at least minScore trigrams.
+    void collectPartialMatches(const vector<uint32_t>& trigrams, size_t minScore, vector<uint8_t>& scores,
+                               vector<uint32_t>& touched, vector<uint32_t>& matches) const;
+
+public:
+    ProductSearchIndex() : postings(TRIGRAM_COUNT), denseBits(TRIGRAM_COUNT), retired(0) {}
+
+    ProductSearchIndex(const ProductSearchIndex&) = delete;
+    ProductSearchIndex& operator=(const ProductSearchIndex&) = delete;
+
+    void rebuild(const ProductCatalog& catalog) {
+        unique_lock<shared_mutex> guard(lock);
+        rebuildLocked(catalog);
+    }
+
+    void apply(const vector<uint32_t>& changedKeys, const ProductCatalog& catalog);
+    vector<SearchHit> search(string_view query, size_t limit) const;
+
+    size_t getDocumentCount() const {
+        shared_lock<shared_mutex> guard(lock);
+        return documents.size() - retired;
+    }
+};
+
+// ==================== INVENTORY ====================
+// Monotonic seconds, for reservation expiry.
+long long steadySeconds();
+
+struct StockLevel {
+    bool tracked;
+    int onHand;
+    int reserved;
+};
+
+// Per-SKU stock counts, one cache line per product, updated by CAS.
+class Inventory {
+private:
+    struct alignas(64) StockCell {
+        atomic<uint64_t> counts{0};
+        atomic<bool> tracked{false};
+    };
+
+    static const int PAGE_BITS = 12;
+    static const uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+    static const uint32_t PAGE_COUNT = 1u << (24 - PAGE_BITS);
+
+    unique_ptr<atomic<StockCell*>[]> pages;
+
+    static uint64_t pack(int onHand, int reserved) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(onHand)) << 32) | static_cast<uint32_t>(reserved);
+    }
+
+    static int onHandOf(uint64_t counts) { return static_cast<int32_t>(static_cast<uint32_t>(counts >> 32)); }
+    static int reservedOf(uint64_t counts) { return static_cast<int32_t>(static_cast<uint32_t>(counts)); }
+
+    StockCell* findCell(uint32_t key) const {
+        if (key == 0 || key >= (1u << 24)) return nullptr;
+        StockCell* page = pages[key >> PAGE_BITS].load(memory_order_acquire);
+        return page != nullptr ? &page[key & (PAGE_SIZE - 1)] : nullptr;
+    }
+
+    StockCell& cellFor(uint32_t key) {
+        atomic<StockCell*>& slot = pages[key >> PAGE_BITS];
+        StockCell* page = slot.load(memory_order_acquire);
+        if (page == nullptr) {
+            StockCell* created = new StockCell[PAGE_SIZE];
+            if (slot.compare_exchange_strong(page, created, memory_order_acq_rel)) {
+                page = created;
+            } else {
+                delete[] created;
+            }
+        }
+        return page[key & (PAGE_SIZE - 1)];
+    }
+
+    template<typename Change>
+    bool update(uint32_t key, Change change) {
+        StockCell* cell = findCell(key);
+        if (cell == nullptr) return false;
+        uint64_t current = cell->counts.load(memory_order_relaxed);
+        for (;;) {
+            int onHand = onHandOf(current);
+            int reserved = reservedOf(current);
+            if (!change(onHand, reserved)) return false;
+            if (cell->counts.compare_exchange_weak(current, pack(onHand, reserved), memory_order_acq_rel)) {
+                return true;
+            }
+        }
+    }
+
+public:
+    Inventory() : pages(new atomic<StockCell*>[PAGE_COUNT]) {
+        for (uint32_t i = 0; i < PAGE_COUNT; i++) {
+            pages[i].store(nullptr, memory_order_relaxed);
+        }
+    }
+
+    Inventory(const Inventory&) = delete;
+    Inventory& operator=(const Inventory&) = delete;
+
+    ~Inventory() {
+        for (uint32_t i = 0; i < PAGE_COUNT; i++) {
+            delete[] pages[i].load(memory_order_relaxed);
+        }
+    }
+
+    void setStock(string_view code, int onHand);
+
+    // Returns false for untracked products; throws OutOfStockException when short.
+    bool reserve(uint32_t key, int quantity) {
+        StockCell* cell = findCell(key);
+        if (cell == nullptr || !cell->tracked.load(memory_order_acquire)) return false;
+
+        bool reserved = update(key, [quantity](int& onHand, int& held) {
+            if (onHand - held < quantity) return false;
+            held += quantity;
+            return true;
+        });
+        if (!reserved) {
+            throw OutOfStockException();
+        }
+        return true;
+    }
+
+    void release(uint32_t key, int quantity) {
+        update(key, [quantity](int&, int& held) {
+            held = max(held - quantity, 0);
+            return true;
+        });
+    }
+
+    void commit(uint32_t key, int quantity) {
+        update(key, [quantity](int& onHand, int& held) {
+            onHand = max(onHand - quantity, 0);
+            held = max(held - quantity, 0);
+            return true;
+        });
+    }
+
+    StockLevel getLevel(string_view code) const;
+};
+
+// ==================== CATALOG HANDLE ====================
+// Epoch-based reclamation for read-mostly data.
+class ReadEpochs {
+private:
+    static const int MAX_READERS = 256;
+
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch;
+        atomic<bool> inUse;
+    };
+
+    struct ThreadSlot {
+        int index;
+        int depth;
+
+        ThreadSlot() : index(-1), depth(0) {}
+        ~ThreadSlot() {
+            if (index >= 0) {
+                slots[index].inUse.store(false, memory_order_release);
+            }
+        }
+    };
+
+    static ReaderSlot slots[MAX_READERS];
+    static atomic<uint64_t> globalEpoch;
+
+    static ThreadSlot& threadSlot() {
+        thread_local ThreadSlot slot;
+        if (slot.index < 0) {
+            for (int i = 0; i < MAX_READERS && slot.index < 0; i++) {
+                bool expected = false;
+                if (slots[i].inUse.compare_exchange_strong(expected, true)) {
+                    slot.index = i;
+                }
+            }
+            if (slot.index < 0) {
+                throw runtime_error("Too many concurrent catalog readers.");
+            }
+        }
+        return slot;
+    }
+
+public:
+    static void enter() {
+        ThreadSlot& slot = threadSlot();
+        if (slot.depth++ == 0) {
+            slots[slot.index].epoch.store(globalEpoch.load());
+        }
+    }
+
+    static void exit() {
+        ThreadSlot& slot = threadSlot();
+        if (--slot.depth == 0) {
+            slots[slot.index].epoch.store(0, memory_order_release);
+        }
+    }
+
+    static void synchronize();
+};
+
+class ReadSection {
+public:
+    ReadSection() { ReadEpochs::enter(); }
+    ~ReadSection() { ReadEpochs::exit(); }
+
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+};
+
+// Copy-on-write catalog: readers never block, writers publish a new version.
+struct CatalogUpdateStats {
+    unsigned long long updates;
+    long long lastUpdateMicros;
+    long long maxUpdateMicros;
+    long long lastGraceWaitMicros;
+    long long maxGraceWaitMicros;
+
+    CatalogUpdateStats() : updates(0), lastUpdateMicros(0), maxUpdateMicros(0),
+                           lastGraceWaitMicros(0), maxGraceWaitMicros(0) {}
+};
+
+class CatalogHandle {
+private:
+    atomic<const ProductCatalog*> current;
+    mutex writerLock;
+    CatalogUpdateStats stats;
+
+public:
+    class ReadGuard {
+    private:
+        const ProductCatalog* catalog;
+
+    public:
+        explicit ReadGuard(const atomic<const ProductCatalog*>& source) {
+            ReadEpochs::enter();
+            catalog = source.load();
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard() {
+            ReadEpochs::exit();
+        }
+
+        const ProductCatalog& operator*() const { return *catalog; }
+        const ProductCatalog* operator->() const { return catalog; }
+    };
+
+    explicit CatalogHandle(ProductCatalog* initial) : current(initial) {}
+
+    CatalogHandle(const CatalogHandle&) = delete;
+    CatalogHandle& operator=(const CatalogHandle&) = delete;
+
+    ~CatalogHandle() {
+        delete current.load();
+    }
+
+    ReadGuard read() const {
+        return ReadGuard(current);
+    }
+
+    void publish(unique_ptr<ProductCatalog> next) {
+        auto start = chrono::steady_clock::now();
+        lock_guard<mutex> guard(writerLock);
+        next->setVersion(current.load()->getVersion() + 1);
+        swapIn(move(next), start);
+    }
+
+    // mutate runs on a private copy, which is then published.
+    void update(const function<void(ProductCatalog&)>& mutate);
+
+    CatalogUpdateStats getStats() {
+        lock_guard<mutex> guard(writerLock);
+        return stats;
+    }
+
+private:
+    void swapIn(unique_ptr<ProductCatalog> next, chrono::steady_clock::time_point start);
+};
+
+#endif
@@ -0,0 +1,19 @@
+#include "common.h"
+
+// ==================== EXCEPTIONS ====================
+const char* storeErrorMessage(StoreError error) {
+    switch (error) {
+        case StoreError::InvalidInput: return InvalidInputException().what();
+        case StoreError::ProductNotFound: return ProductNotFoundException().what();
+        case StoreError::EmptyCart: return EmptyCartException().what();
+        default: return "";
+    }
+}
+
+[[noreturn]] void throwStoreError(StoreError error) {
+    switch (error) {
+        case StoreError::ProductNotFound: throw ProductNotFoundException();
+        case StoreError::EmptyCart: throw EmptyCartException();
+        default: throw InvalidInputException();
+    }
+}
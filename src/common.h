@@ -0,0 +1,135 @@
+#ifndef STORE_COMMON_H
+#define STORE_COMMON_H
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cctype>
+#include <sstream>
+#include <climits>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <vector>
+#include <array>
+#include <memory>
+#include <cmath>
+#include <type_traits>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <deque>
+#include <queue>
+#include <unordered_map>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <future>
+#include <random>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// ==================== CONSTANTS ====================
+const int PRODUCT_CODE_LENGTH = 3;
+const int MAX_PRODUCT_NAME_LENGTH = 50;
+const int MAX_PAYMENT_METHOD_LENGTH = 50;
+const int SEARCH_RESULT_LIMIT = 10;
+
+// ==================== EXCEPTIONS ====================
+class InvalidInputException : public exception {
+public:
+    const char* what() const throw() {
+        return "Invalid input! Please enter a valid product code.";
+    }
+};
+
+class ProductNotFoundException : public exception {
+public:
+    const char* what() const throw() {
+        return "Product code not found.";
+    }
+};
+
+class EmptyCartException : public exception {
+public:
+    const char* what() const throw() {
+        return "Shopping cart is empty.";
+    }
+};
+
+class OutOfStockException : public exception {
+public:
+    const char* what() const throw() {
+        return "Not enough stock available.";
+    }
+};
+
+class PaymentFailedException : public exception {
+private:
+    const char* reason;
+
+public:
+    explicit PaymentFailedException(const char* reason) : reason(reason) {}
+
+    const char* what() const throw() {
+        return reason;
+    }
+};
+
+// Misses that hot paths report by value instead of by throwing.
+enum class StoreError {
+    None,
+    InvalidInput,
+    ProductNotFound,
+    EmptyCart
+};
+
+const char* storeErrorMessage(StoreError error);
+
+[[noreturn]] void throwStoreError(StoreError error);
+
+// A value or the StoreError explaining why there is none.
+template<typename T>
+class Result {
+private:
+    T value;
+    StoreError error;
+
+public:
+    Result(const T& value) : value(value), error(StoreError::None) {}
+    Result(StoreError error) : value(), error(error) {}
+
+    bool ok() const { return error == StoreError::None; }
+    explicit operator bool() const { return ok(); }
+    const T& getValue() const { return value; }
+    StoreError getError() const { return error; }
+
+    const T& valueOrThrow() const {
+        if (!ok()) {
+            throwStoreError(error);
+        }
+        return value;
+    }
+};
+
+#endif
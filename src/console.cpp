@@ -0,0 +1,104 @@
+#include "console.h"
+
+// ==================== INPUT VALIDATION ====================
+string_view trimView(string_view text) {
+    const char* spaces = " \t\n\r\f\v";
+    size_t start = text.find_first_not_of(spaces);
+    if (start == string_view::npos) return string_view();
+    size_t end = text.find_last_not_of(spaces);
+    return text.substr(start, end - start + 1);
+}
+
+string_view readConsoleLine() {
+    static string line;
+    getline(cin, line);
+    return line;
+}
+
+char getYesNoInput(const string& prompt) {
+    bool valid = false;
+    char result = '\0';
+    
+    while (!valid) {
+        cout << prompt;
+        string_view input = trimView(readConsoleLine());
+        
+        if (input.length() == 1 && (toupper(input[0]) == 'Y' || toupper(input[0]) == 'N')) {
+            result = toupper(input[0]);
+            valid = true;
+        } else {
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║          ❗ INVALID INPUT                  ║\n";
+            cout << "║ Please enter Y or N                       ║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+        }
+    }
+    return result;
+}
+
+string getProductCodeInput(const string& prompt, const function<bool(string_view)>& isKnownCode) {
+    char code[PRODUCT_CODE_LENGTH + 1] = {};
+    bool valid = false;
+    
+    while (!valid) {
+        cout << prompt;
+        string_view input = trimView(readConsoleLine());
+        
+        if (input == "0") {
+            return "0";
+        } else if (!input.empty() && input[0] == '?') {
+            return string(input);
+        } else if (input.length() == PRODUCT_CODE_LENGTH) {
+            for (int i = 0; i < PRODUCT_CODE_LENGTH; i++) {
+                code[i] = toupper(input[i]);
+            }
+            valid = isKnownCode(string_view(code, PRODUCT_CODE_LENGTH));
+            if (!valid) {
+                cout << "╔════════════════════════════════════════════╗\n";
+                cout << "║          ❗ PRODUCT NOT FOUND             ║\n";
+                cout << "║ Please enter a valid 3-letter product code║\n";
+                cout << "╚════════════════════════════════════════════╝\n";
+            }
+        } else {
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║          ❗ INVALID INPUT                  ║\n";
+            cout << "║ Product codes must be exactly 3 letters   ║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+        }
+    }
+    return code;
+}
+
+// ==================== RENDERING ====================
+RenderBuffer& RenderBuffer::field(string_view value, size_t width, bool alignLeft) {
+    size_t padding = value.size() < width ? width - value.size() : 0;
+    if (!alignLeft) text.append(padding, ' ');
+    text.append(value.data(), value.size());
+    if (alignLeft) text.append(padding, ' ');
+    return *this;
+}
+
+bool renderPaged(RenderBuffer& screen, size_t total, size_t rowsPerPage,
+                 const function<void(RenderBuffer&)>& header,
+                 const function<void(RenderBuffer&, size_t)>& row,
+                 const function<void(RenderBuffer&, bool)>& footer) {
+    size_t pages = max<size_t>((total + rowsPerPage - 1) / rowsPerPage, 1);
+    for (size_t page = 0; page < pages; page++) {
+        header(screen);
+        size_t end = min(total, (page + 1) * rowsPerPage);
+        for (size_t i = page * rowsPerPage; i < end; i++) {
+            row(screen, i);
+        }
+        footer(screen, page + 1 == pages);
+        screen.flush(cout);
+
+        if (page + 1 < pages) {
+            cout << "➡ Page " << page + 1 << " of " << pages << " - Enter for more, Q to stop: ";
+            string_view input = trimView(readConsoleLine());
+            if (!cin || (input.length() == 1 && toupper(input[0]) == 'Q')) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
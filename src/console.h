@@ -0,0 +1,135 @@
+#ifndef STORE_CONSOLE_H
+#define STORE_CONSOLE_H
+
+#include "money.h"
+
+// ==================== INPUT VALIDATION ====================
+// Input parsing works on views and never allocates.
+string_view trimView(string_view text);
+
+enum class ParseStatus { Ok, Invalid, TrailingCharacters };
+
+// Parses all of text as a T; a leading '+' is accepted.
+template<typename T>
+ParseStatus parseNumber(string_view text, T& value) {
+    static_assert(is_arithmetic<T>::value && !is_same<T, bool>::value, "parseNumber needs a numeric type");
+
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+        text.remove_prefix(1);
+    }
+
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+
+    from_chars_result result;
+
+    if constexpr (is_integral<T>::value) {
+        result = from_chars(first, last, value);
+    } else {
+        result = from_chars(first, last, value, chars_format::general);
+    }
+
+    if (result.ec != errc() || result.ptr == first) return ParseStatus::Invalid;
+    if (result.ptr != last) return ParseStatus::TrailingCharacters;
+    return ParseStatus::Ok;
+}
+
+string_view readConsoleLine();
+
+char getYesNoInput(const string& prompt);
+
+string getProductCodeInput(const string& prompt, const function<bool(string_view)>& isKnownCode);
+
+template<typename T>
+T getValidInput(const string& prompt, T min = numeric_limits<T>::min(), T max = numeric_limits<T>::max()) {
+    T value = T();
+    bool valid = false;
+    
+    while (!valid) {
+        cout << prompt;
+        string_view input = trimView(readConsoleLine());
+        
+        if (input.find(' ') != string_view::npos) {
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║          ❗ INVALID INPUT                  ║\n";
+            cout << "║ No spaces allowed. Enter a single number.  ║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+            continue;
+        }
+        
+        ParseStatus status = parseNumber(input, value);
+        if (status == ParseStatus::Ok && value >= min && value <= max) {
+            valid = true;
+        } else if (status == ParseStatus::TrailingCharacters && value >= min && value <= max) {
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║          ❗ INVALID INPUT                  ║\n";
+            cout << "║ No extra characters allowed.              ║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+        } else {
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║          ❗ INVALID INPUT                  ║\n";
+            cout << "║ Please enter a positive number            ║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+        }
+    }
+
+    return value;
+}
+
+// ==================== RENDERING ====================
+// Formats a view into one reusable buffer and writes it with a single call.
+class RenderBuffer {
+private:
+    string text;
+
+    RenderBuffer& field(string_view value, size_t width, bool alignLeft);
+
+public:
+    RenderBuffer& add(string_view value) {
+        text.append(value.data(), value.size());
+        return *this;
+    }
+
+    RenderBuffer& left(string_view value, size_t width) { return field(value, width, true); }
+    RenderBuffer& right(string_view value, size_t width) { return field(value, width, false); }
+
+    RenderBuffer& left(long long value, size_t width) {
+        char buffer[24];
+        return field(string_view(buffer, to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer), width, true);
+    }
+
+    RenderBuffer& right(long long value, size_t width) {
+        char buffer[24];
+        return field(string_view(buffer, to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer), width, false);
+    }
+
+    RenderBuffer& left(Money value, size_t width) {
+        char buffer[Money::MAX_TEXT_LENGTH];
+        return field(string_view(buffer, value.format(buffer) - buffer), width, true);
+    }
+
+    RenderBuffer& right(Money value, size_t width) {
+        char buffer[Money::MAX_TEXT_LENGTH];
+        return field(string_view(buffer, value.format(buffer) - buffer), width, false);
+    }
+
+    size_t size() const { return text.size(); }
+    void clear() { text.clear(); }
+
+    void flush(ostream& out) {
+        out.write(text.data(), static_cast<streamsize>(text.size()));
+        out.flush();
+        text.clear();
+    }
+};
+
+const size_t PAGE_ROWS = 20;
+const size_t ORDERS_PER_PAGE = 5;
+
+// Renders rows a page at a time; returns false if the user stopped early.
+bool renderPaged(RenderBuffer& screen, size_t total, size_t rowsPerPage,
+                 const function<void(RenderBuffer&)>& header,
+                 const function<void(RenderBuffer&, size_t)>& row,
+                 const function<void(RenderBuffer&, bool)>& footer);
+
+#endif
@@ -0,0 +1,167 @@
+#include "engine.h"
+
+// ==================== STORE ENGINE ====================
+void StoreEngine::updateCatalog(const function<void(ProductCatalog&)>& mutate) {
+    vector<uint32_t> changed;
+    catalog.update([&](ProductCatalog& next) {
+        next.clearNameChanges();
+        mutate(next);
+        changed = next.getNameChanges();
+    });
+    if (!changed.empty()) {
+        lock_guard<mutex> guard(searchUpdateLock);
+        search.apply(changed, *catalog.read());
+    }
+}
+
+void StoreEngine::loadCatalog(const string& path) {
+    unique_ptr<ProductCatalog> next(new ProductCatalog());
+    next->loadBinary(path);
+    catalog.publish(move(next));
+    lock_guard<mutex> guard(searchUpdateLock);
+    search.rebuild(*catalog.read());
+}
+
+void StoreEngine::openJournal(const string& path) {
+    journal.reset(new OrderJournal(path));
+    int nextOrderId = journal->recover(
+        [this](const JournalOrder& order) {
+            analytics.record(orders.restore(order));
+        },
+        [this](const JournalOrder& order) {
+            analytics.record(Order(order.orderId, order.lines.data(), static_cast<int>(order.lines.size()),
+                                   order.total, order.placedAt, order.paymentMethod.c_str(),
+                                   order.discount, order.promotionIds));
+        });
+    Order::setNextOrderId(nextOrderId);
+}
+
+size_t StoreEngine::compactOrders() {
+    if (!journal || !retention.isEnabled()) return 0;
+    lock_guard<mutex> guard(compactionLock);
+    long long now = Order::currentTime();
+    nextAgeCheck = now + AGE_CHECK_SECONDS;
+
+    vector<const Order*> expired = orders.findExpired(retention, now);
+    if (expired.empty()) return 0;
+    journal->archive(expired);
+
+    vector<int> ids;
+    for (const Order* order : expired) {
+        ids.push_back(order->getOrderId());
+    }
+    orders.evict(ids);
+    journal->snapshot([this]() { return orders.collect(); });
+    return ids.size();
+}
+
+const Order& StoreEngine::placeOrder(int orderId, const ShoppingCart& cart, PaymentStrategy* paymentStrategy,
+                                     const CartPricing& pricing) {
+    vector<OrderLine> lines(static_cast<size_t>(cart.getItemCount()));
+    Order placed(orderId, cart, paymentStrategy, pricing, lines.data());
+
+    // Stored only once journaled, so a failed write leaves no order behind.
+    ReadSection reading;
+    const Order* stored = nullptr;
+    if (journal) {
+        journal->append(placed, [&]() { stored = &orders.add(placed); });
+        try {
+            journal->snapshotIfDue([this]() { return orders.collect(); });
+        } catch (const exception&) {
+            // The order is already journaled; the next order retries the snapshot.
+        }
+    } else {
+        stored = &orders.add(placed);
+    }
+    const Order& order = *stored;
+
+    OrderLogger::getInstance()->logOrder(order.getOrderId(), order.getPaymentMethod());
+    analytics.record(order);
+    return order;
+}
+
+// ==================== BATCH REQUESTS ====================
+bool BatchRequest::parseString(size_t& pos, uint32_t& offset, uint32_t& length) {
+    if (pos >= text.size() || text[pos] != '"') return false;
+    pos++;
+    size_t out = pos;
+    offset = static_cast<uint32_t>(out);
+    while (pos < text.size() && text[pos] != '"') {
+        if (text[pos] == '\\' && pos + 1 < text.size()) {
+            pos++;
+            switch (text[pos]) {
+                case 'n': text[out++] = '\n'; break;
+                case 't': text[out++] = '\t'; break;
+                case 'r': text[out++] = '\r'; break;
+                default: text[out++] = text[pos]; break;
+            }
+        } else {
+            text[out++] = text[pos];
+        }
+        pos++;
+    }
+    if (pos >= text.size()) return false;
+    length = static_cast<uint32_t>(out - offset);
+    pos++;
+    return true;
+}
+
+bool BatchRequest::parse(string_view line) {
+    text.assign(line.data(), line.size());
+    fieldCount = 0;
+    size_t pos = 0;
+    skipSpaces(pos);
+    if (pos >= text.size() || text[pos] != '{') return false;
+    pos++;
+    skipSpaces(pos);
+    if (pos < text.size() && text[pos] == '}') return true;
+
+    while (pos < text.size()) {
+        Field field;
+        skipSpaces(pos);
+        if (!parseString(pos, field.keyOffset, field.keyLength)) return false;
+        skipSpaces(pos);
+        if (pos >= text.size() || text[pos] != ':') return false;
+        pos++;
+        skipSpaces(pos);
+        if (pos < text.size() && text[pos] == '"') {
+            if (!parseString(pos, field.valueOffset, field.valueLength)) return false;
+        } else {
+            size_t start = pos;
+            while (pos < text.size() && text[pos] != ',' && text[pos] != '}' &&
+                   !isspace(static_cast<unsigned char>(text[pos]))) {
+                pos++;
+            }
+            if (pos == start) return false;
+            field.valueOffset = static_cast<uint32_t>(start);
+            field.valueLength = static_cast<uint32_t>(pos - start);
+        }
+        if (fieldCount < 8) {
+            fields[fieldCount++] = field;
+        }
+        skipSpaces(pos);
+        if (pos < text.size() && text[pos] == ',') {
+            pos++;
+        } else if (pos < text.size() && text[pos] == '}') {
+            return true;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+void writeJsonString(ostream& out, string_view value) {
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            case '\r': out << "\\r"; break;
+            default: out << c; break;
+        }
+    }
+    out << '"';
+}
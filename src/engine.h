@@ -0,0 +1,141 @@
+#ifndef STORE_ENGINE_H
+#define STORE_ENGINE_H
+
+#include "order_store.h"
+#include "logger.h"
+
+// ==================== STORE ENGINE ====================
+// State shared by every session: catalog, orders and journal.
+class StoreEngine {
+private:
+    CatalogHandle catalog;
+    OrderStore orders;
+    unique_ptr<OrderJournal> journal;
+    PaymentRegistry payments;
+    SalesAnalytics analytics;
+    Inventory inventory;
+    ProductSearchIndex search;
+    PromotionEngine promotions;
+    mutex searchUpdateLock;
+    OrderRetention retention;
+    mutex compactionLock;
+    atomic<long long> nextAgeCheck;
+
+    static const long long AGE_CHECK_SECONDS = 60;
+
+public:
+    StoreEngine() : catalog(new ProductCatalog()), orders(max(thread::hardware_concurrency(), 1u) * 2), nextAgeCheck(0) {
+        search.rebuild(*catalog.read());
+    }
+
+    CatalogHandle& getCatalog() { return catalog; }
+    PaymentRegistry& getPayments() { return payments; }
+    const SalesAnalytics& getAnalytics() const { return analytics; }
+    Inventory& getInventory() { return inventory; }
+    PromotionEngine& getPromotions() { return promotions; }
+
+    void setStockForAll(int onHand) {
+        CatalogHandle::ReadGuard current = catalog.read();
+        for (int i = 0; i < current->getProductCount(); i++) {
+            inventory.setStock(current->getProducts()[i].getId(), onHand);
+        }
+    }
+
+    const OrderStore& getOrders() const { return orders; }
+
+    void updateCatalog(const function<void(ProductCatalog&)>& mutate);
+    void loadCatalog(const string& path);
+
+    vector<SearchHit> searchProducts(string_view query, size_t limit) const {
+        return search.search(query, limit);
+    }
+
+    void openJournal(const string& path);
+
+    void setRetention(const OrderRetention& policy) {
+        if (policy.isEnabled() && !journal) {
+            throw runtime_error("Order retention needs an order journal.");
+        }
+        retention = policy;
+    }
+
+    // Must not be called inside a read section.
+    size_t compactOrders();
+
+    size_t compactIfDue() {
+        if (!journal || !retention.isEnabled()) return 0;
+        bool overCount = retention.maxOrders > 0 && orders.size() > retention.maxOrders + retention.maxOrders / 4;
+        bool ageCheckDue = retention.maxAgeSeconds > 0 && Order::currentTime() >= nextAgeCheck.load();
+        return overCount || ageCheckDue ? compactOrders() : 0;
+    }
+
+    // Taken before payment, as the idempotency key.
+    int reserveOrderId() {
+        return Order::allocateOrderId();
+    }
+
+    CartPricing priceCart(const ShoppingCart& cart, const string& paymentMethod) const {
+        return promotions.price(cart, paymentMethod);
+    }
+
+    // Valid while the caller holds a ReadSection. If it throws, no order was
+    // recorded and a captured payment should be refunded.
+    const Order& placeOrder(int orderId, const ShoppingCart& cart, PaymentStrategy* paymentStrategy,
+                            const CartPricing& pricing);
+};
+
+// ==================== BATCH REQUESTS ====================
+// One flat JSON object per line, e.g. {"op":"add","code":"LAP","qty":2}.
+class BatchRequest {
+private:
+    struct Field {
+        uint32_t keyOffset;
+        uint32_t keyLength;
+        uint32_t valueOffset;
+        uint32_t valueLength;
+    };
+
+    string text;
+    Field fields[8];
+    int fieldCount;
+
+    void skipSpaces(size_t& pos) const {
+        while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+    }
+
+    bool parseString(size_t& pos, uint32_t& offset, uint32_t& length);
+
+    const Field* findField(string_view key) const {
+        for (int i = 0; i < fieldCount; i++) {
+            if (string_view(text.data() + fields[i].keyOffset, fields[i].keyLength) == key) return &fields[i];
+        }
+        return nullptr;
+    }
+
+public:
+    BatchRequest() : fieldCount(0) {}
+
+    bool parse(string_view line);
+
+    bool has(string_view key) const {
+        return findField(key) != nullptr;
+    }
+
+    string_view getString(string_view key) const {
+        const Field* field = findField(key);
+        if (field == nullptr) return string_view();
+        return string_view(text.data() + field->valueOffset, field->valueLength);
+    }
+
+    bool getInt(string_view key, long long& out) const {
+        const Field* field = findField(key);
+        if (field == nullptr) return false;
+        return parseNumber(getString(key), out) == ParseStatus::Ok;
+    }
+};
+
+void writeJsonString(ostream& out, string_view value);
+
+#endif
@@ -0,0 +1,447 @@
+#include "journal.h"
+
+// ==================== ORDER JOURNAL ====================
+void OrderJournal::frame(const string& payload, string& out) {
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    uint32_t checksum = crc32(payload.data(), payload.size());
+    put(out, length);
+    put(out, checksum);
+    out += payload;
+}
+
+size_t OrderJournal::readRecords(const string& buffer, size_t offset,
+                                 const function<void(const JournalOrder&)>& apply) {
+    JournalOrder order;
+    while (buffer.size() - offset >= 8) {
+        uint32_t length, checksum;
+        memcpy(&length, buffer.data() + offset, sizeof(length));
+        memcpy(&checksum, buffer.data() + offset + 4, sizeof(checksum));
+        if (buffer.size() - offset - 8 < length) break;
+
+        const char* payload = buffer.data() + offset + 8;
+        if (crc32(payload, length) != checksum || !decodeOrder(payload, length, order)) break;
+
+        apply(order);
+        offset += 8 + length;
+    }
+    return offset;
+}
+
+bool OrderJournal::readFile(const string& path, string& buffer) {
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+    in.seekg(0, ios::end);
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0, ios::beg);
+    in.read(&buffer[0], static_cast<streamsize>(buffer.size()));
+    return true;
+}
+
+uint32_t OrderJournal::crc32(const char* data, size_t size) {
+    static const array<uint32_t, 256> table = []() {
+        array<uint32_t, 256> entries;
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+        return entries;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void OrderJournal::encodeOrder(const JournalOrder& order, string& payload) {
+    payload.clear();
+    put(payload, JOURNAL_RECORD_ORDER);
+    put(payload, static_cast<int32_t>(order.orderId));
+    put(payload, static_cast<int64_t>(order.placedAt));
+    put(payload, static_cast<int64_t>(order.total.getCents()));
+    put(payload, static_cast<uint8_t>(order.paymentMethod.size()));
+    payload += order.paymentMethod;
+    put(payload, static_cast<uint32_t>(order.lines.size()));
+    for (const OrderLine& line : order.lines) {
+        payload.append(line.code, PRODUCT_CODE_LENGTH + 1);
+        put(payload, static_cast<int32_t>(line.quantity));
+        put(payload, static_cast<int64_t>(line.unitPrice.getCents()));
+    }
+    put(payload, static_cast<int64_t>(order.discount.getCents()));
+    put(payload, static_cast<uint8_t>(order.promotionIds.size()));
+    for (int id : order.promotionIds) {
+        put(payload, static_cast<int32_t>(id));
+    }
+}
+
+bool OrderJournal::decodeOrder(const char* data, size_t size, JournalOrder& order) {
+    const char* end = data + size;
+    uint8_t type, methodLength;
+    int32_t orderId;
+    int64_t placedAt = 0;
+    int64_t totalCents;
+    uint32_t lineCount;
+
+    if (!get(data, end, type) || type < JOURNAL_RECORD_ORDER_V1 || type > JOURNAL_RECORD_ORDER) return false;
+    if (!get(data, end, orderId)) return false;
+    if (type != JOURNAL_RECORD_ORDER_V1 && !get(data, end, placedAt)) return false;
+    if (!get(data, end, totalCents) || !get(data, end, methodLength)) return false;
+    if (static_cast<size_t>(end - data) < methodLength) return false;
+    order.orderId = orderId;
+    order.placedAt = placedAt;
+    order.total = Money::fromCents(totalCents);
+    order.paymentMethod.assign(data, methodLength);
+    data += methodLength;
+
+    if (!get(data, end, lineCount)) return false;
+    if (lineCount > static_cast<size_t>(end - data) / (PRODUCT_CODE_LENGTH + 1 + 12)) return false;
+    order.lines.resize(lineCount);
+    for (OrderLine& line : order.lines) {
+        int32_t quantity = 0;
+        int64_t unitPriceCents = 0;
+        memcpy(line.code, data, PRODUCT_CODE_LENGTH + 1);
+        line.code[PRODUCT_CODE_LENGTH] = '\0';
+        data += PRODUCT_CODE_LENGTH + 1;
+        get(data, end, quantity);
+        get(data, end, unitPriceCents);
+        line.quantity = quantity;
+        line.unitPrice = Money::fromCents(unitPriceCents);
+    }
+
+    int64_t discountCents = 0;
+    uint8_t promotionCount = 0;
+    if (type == JOURNAL_RECORD_ORDER && (!get(data, end, discountCents) || !get(data, end, promotionCount))) {
+        return false;
+    }
+    order.discount = Money::fromCents(discountCents);
+    order.promotionIds.resize(promotionCount);
+    for (int& id : order.promotionIds) {
+        int32_t stored = 0;
+        if (!get(data, end, stored)) return false;
+        id = stored;
+    }
+    return data == end;
+}
+
+void OrderJournal::toJournalOrder(const Order& order, JournalOrder& out) {
+    out.orderId = order.getOrderId();
+    out.placedAt = order.getPlacedAt();
+    out.total = order.getTotalAmount();
+    out.paymentMethod = order.getPaymentMethod();
+    out.lines.assign(order.getLines(), order.getLines() + order.getLineCount());
+    out.discount = order.getDiscountAmount();
+    out.promotionIds.assign(order.getPromotionIds(), order.getPromotionIds() + order.getPromotionCount());
+}
+
+int OrderJournal::recover(const function<void(const JournalOrder&)>& apply,
+                          const function<void(const JournalOrder&)>& applyArchived) {
+    lock_guard<mutex> guard(lock);
+    int nextOrderId = 1;
+    string buffer;
+    vector<int> archivedIds;
+    vector<int> snapshotIds;
+
+    if (readFile(archivePath, buffer)) {
+        size_t valid = readRecords(buffer, 0, [&](const JournalOrder& order) {
+            applyArchived(order);
+            archivedIds.push_back(order.orderId);
+            nextOrderId = max(nextOrderId, order.orderId + 1);
+        });
+        if (valid < buffer.size()) {
+            filesystem::resize_file(archivePath, valid);
+        }
+    }
+    sort(archivedIds.begin(), archivedIds.end());
+    auto isArchived = [&archivedIds](int orderId) {
+        return binary_search(archivedIds.begin(), archivedIds.end(), orderId);
+    };
+
+    if (readFile(snapshotPath, buffer) && buffer.size() >= sizeof(SnapshotHeader)) {
+        SnapshotHeader header;
+        memcpy(&header, buffer.data(), sizeof(header));
+        if (memcmp(header.magic, SNAPSHOT_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+            header.version >= 1 && header.version <= SNAPSHOT_FILE_VERSION) {
+            nextOrderId = header.nextOrderId;
+            snapshotOrders = static_cast<size_t>(header.orderCount);
+            readRecords(buffer, sizeof(header), [&](const JournalOrder& order) {
+                if (isArchived(order.orderId)) return;
+                apply(order);
+                snapshotIds.push_back(order.orderId);
+                nextOrderId = max(nextOrderId, order.orderId + 1);
+            });
+        }
+    }
+    sort(snapshotIds.begin(), snapshotIds.end());
+
+    if (readFile(journalPath, buffer)) {
+        size_t valid = readRecords(buffer, 0, [&](const JournalOrder& order) {
+            if (!binary_search(snapshotIds.begin(), snapshotIds.end(), order.orderId) &&
+                !isArchived(order.orderId)) {
+                apply(order);
+                nextOrderId = max(nextOrderId, order.orderId + 1);
+                recordsSinceSnapshot++;
+            }
+        });
+        if (valid < buffer.size()) {
+            filesystem::resize_file(journalPath, valid);
+        }
+    }
+
+    file = fopen(journalPath.c_str(), "ab");
+    if (file == nullptr) {
+        throw runtime_error("Failed to open order journal.");
+    }
+    return nextOrderId;
+}
+
+void OrderJournal::append(const Order& order, const function<void()>& publish) {
+    JournalOrder entry;
+    string payload, record;
+    toJournalOrder(order, entry);
+    encodeOrder(entry, payload);
+    frame(payload, record);
+
+    lock_guard<mutex> guard(lock);
+    if (file == nullptr || fwrite(record.data(), 1, record.size(), file) != record.size() || fflush(file) != 0) {
+        throw runtime_error("Failed to write order journal.");
+    }
+    recordsSinceSnapshot++;
+    publish();
+}
+
+void OrderJournal::archive(const vector<const Order*>& orders) {
+    JournalOrder entry;
+    string payload, buffer;
+    for (const Order* order : orders) {
+        toJournalOrder(*order, entry);
+        encodeOrder(entry, payload);
+        frame(payload, buffer);
+    }
+
+    lock_guard<mutex> guard(lock);
+    FILE* archiveFile = fopen(archivePath.c_str(), "ab");
+    if (archiveFile == nullptr) {
+        throw runtime_error("Failed to open order archive.");
+    }
+    bool written = fwrite(buffer.data(), 1, buffer.size(), archiveFile) == buffer.size() && fflush(archiveFile) == 0;
+    fclose(archiveFile);
+    if (!written) {
+        throw runtime_error("Failed to write order archive.");
+    }
+}
+
+void OrderJournal::snapshotIfDue(const function<vector<const Order*>()>& gatherOrders) {
+    lock_guard<mutex> guard(lock);
+    if (static_cast<size_t>(recordsSinceSnapshot) < max(static_cast<size_t>(SNAPSHOT_INTERVAL), snapshotOrders)) {
+        return;
+    }
+    writeSnapshot(gatherOrders);
+}
+
+void OrderJournal::writeSnapshot(const function<vector<const Order*>()>& gatherOrders) {
+    vector<const Order*> orders = gatherOrders();
+    string tempPath = snapshotPath + ".tmp";
+    string buffer, payload;
+    JournalOrder entry;
+
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_FILE_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_FILE_VERSION;
+    header.nextOrderId = Order::getNextOrderId();
+    header.reserved = 0;
+    header.orderCount = orders.size();
+    put(buffer, header);
+
+    for (const Order* order : orders) {
+        toJournalOrder(*order, entry);
+        encodeOrder(entry, payload);
+        frame(payload, buffer);
+    }
+
+    {
+        ofstream out(tempPath, ios::binary | ios::trunc);
+        out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        if (!out) {
+            throw runtime_error("Failed to write order snapshot.");
+        }
+    }
+    filesystem::rename(tempPath, snapshotPath);
+
+    if (file != nullptr) {
+        fclose(file);
+    }
+    file = fopen(journalPath.c_str(), "wb");
+    if (file == nullptr) {
+        throw runtime_error("Failed to reopen order journal.");
+    }
+    recordsSinceSnapshot = 0;
+    snapshotOrders = orders.size();
+}
+
+// ==================== CART SNAPSHOTS ====================
+bool CartStore::parseRecord(const char* payload, uint32_t length, string_view& session, uint32_t& lineCount) {
+    uint32_t sessionLength;
+    if (length < RECORD_PREFIX + 4 || static_cast<uint8_t>(payload[0]) != CART_RECORD) return false;
+    memcpy(&sessionLength, payload + 1, sizeof(sessionLength));
+    if (sessionLength > length - RECORD_PREFIX - 4) return false;
+    memcpy(&lineCount, payload + RECORD_PREFIX + sessionLength, sizeof(lineCount));
+    session = string_view(payload + RECORD_PREFIX, sessionLength);
+    return length - RECORD_PREFIX - 4 - sessionLength == static_cast<uint64_t>(lineCount) * sizeof(CartItem);
+}
+
+void CartStore::writerLoop() {
+    string batch;
+    unique_lock<mutex> guard(lock);
+    for (;;) {
+        hasWork.wait(guard, [this]() { return !pending.empty() || closing; });
+        if (pending.empty()) break;
+        batch.swap(pending);
+        guard.unlock();
+
+        if (fwrite(batch.data(), 1, batch.size(), file) != batch.size() || fflush(file) != 0) {
+            failedWrites++;
+        }
+        writes++;
+        batch.clear();
+        guard.lock();
+    }
+}
+
+CartStore::~CartStore() {
+    if (writer.joinable()) {
+        {
+            lock_guard<mutex> guard(lock);
+            closing = true;
+        }
+        hasWork.notify_one();
+        writer.join();
+    }
+    if (file != nullptr) {
+        fclose(file);
+    }
+}
+
+void CartStore::encodeCart(string_view session, const ShoppingCart& cart, string& out) {
+    size_t start = out.size();
+    uint32_t sessionLength = static_cast<uint32_t>(session.size());
+    uint32_t lineCount = static_cast<uint32_t>(cart.getItemCount());
+
+    out.resize(start + 8);
+    out.push_back(static_cast<char>(CART_RECORD));
+    out.append(reinterpret_cast<const char*>(&sessionLength), sizeof(sessionLength));
+    out.append(session.data(), session.size());
+    out.append(reinterpret_cast<const char*>(&lineCount), sizeof(lineCount));
+    out.append(reinterpret_cast<const char*>(cart.getItems()), lineCount * sizeof(CartItem));
+
+    uint32_t length = static_cast<uint32_t>(out.size() - start - 8);
+    uint32_t checksum = OrderJournal::crc32(out.data() + start + 8, length);
+    memcpy(&out[start], &length, sizeof(length));
+    memcpy(&out[start + 4], &checksum, sizeof(checksum));
+}
+
+size_t CartStore::recover(const function<void(string_view, const CartItem*, size_t)>& restore) {
+    string buffer;
+    ifstream in(path, ios::binary);
+    if (in.is_open()) {
+        in.seekg(0, ios::end);
+        buffer.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0, ios::beg);
+        in.read(&buffer[0], static_cast<streamsize>(buffer.size()));
+        in.close();
+    }
+
+    size_t offset = 0;
+    if (!buffer.empty()) {
+        CartFileHeader header;
+        if (buffer.size() < sizeof(header)) {
+            throw runtime_error("Invalid cart file.");
+        }
+        memcpy(&header, buffer.data(), sizeof(header));
+        if (memcmp(header.magic, CART_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != CART_FILE_VERSION) {
+            throw runtime_error("Invalid cart file.");
+        }
+        offset = sizeof(header);
+    }
+
+    unordered_map<string_view, pair<size_t, size_t>> newest;
+    while (buffer.size() - offset >= 8) {
+        uint32_t length, checksum, lineCount;
+        string_view session;
+        memcpy(&length, buffer.data() + offset, sizeof(length));
+        memcpy(&checksum, buffer.data() + offset + 4, sizeof(checksum));
+        if (buffer.size() - offset - 8 < length) break;
+
+        const char* payload = buffer.data() + offset + 8;
+        if (OrderJournal::crc32(payload, length) != checksum || !parseRecord(payload, length, session, lineCount)) break;
+        newest[session] = make_pair(offset, 8 + static_cast<size_t>(length));
+        offset += 8 + length;
+    }
+
+    CartFileHeader header;
+    memcpy(header.magic, CART_FILE_MAGIC, sizeof(header.magic));
+    header.version = CART_FILE_VERSION;
+    string compacted(reinterpret_cast<const char*>(&header), sizeof(header));
+    vector<CartItem> lines;
+    size_t restored = 0;
+
+    for (const pair<const string_view, pair<size_t, size_t>>& entry : newest) {
+        const char* payload = buffer.data() + entry.second.first + 8;
+        uint32_t lineCount;
+        memcpy(&lineCount, payload + RECORD_PREFIX + entry.first.size(), sizeof(lineCount));
+        if (lineCount == 0) continue;
+
+        lines.resize(lineCount);
+        memcpy(static_cast<void*>(lines.data()), payload + RECORD_PREFIX + entry.first.size() + 4,
+               lineCount * sizeof(CartItem));
+        if (!all_of(lines.begin(), lines.end(), isValidLine)) continue;
+        restore(entry.first, lines.data(), lineCount);
+        compacted.append(buffer, entry.second.first, entry.second.second);
+        restored++;
+    }
+
+    string tempPath = path + ".tmp";
+    {
+        ofstream out(tempPath, ios::binary | ios::trunc);
+        out.write(compacted.data(), static_cast<streamsize>(compacted.size()));
+        if (!out) {
+            throw runtime_error("Failed to write cart file.");
+        }
+    }
+    filesystem::rename(tempPath, path);
+
+    file = fopen(path.c_str(), "ab");
+    if (file == nullptr) {
+        throw runtime_error("Failed to open cart file.");
+    }
+    writer = thread(&CartStore::writerLoop, this);
+    return restored;
+}
+
+void CartStore::save(string& records, size_t cartCount) {
+    if (records.empty()) return;
+    {
+        lock_guard<mutex> guard(lock);
+        if (pending.empty()) {
+            pending.swap(records);
+        } else {
+            pending += records;
+        }
+    }
+    records.clear();
+    cartsSaved += cartCount;
+    hasWork.notify_one();
+}
+
+CartStoreStats CartStore::getStats() {
+    CartStoreStats stats;
+    stats.cartsSaved = cartsSaved.load();
+    stats.writes = writes.load();
+    stats.failedWrites = failedWrites.load();
+    lock_guard<mutex> guard(lock);
+    stats.pendingBytes = pending.size();
+    return stats;
+}
@@ -0,0 +1,165 @@
+#ifndef STORE_JOURNAL_H
+#define STORE_JOURNAL_H
+
+#include "order.h"
+
+// ==================== ORDER JOURNAL ====================
+// Journal records are framed as [u32 length][u32 CRC-32][payload].
+const uint8_t JOURNAL_RECORD_ORDER_V1 = 1;
+const uint8_t JOURNAL_RECORD_ORDER_V2 = 2;
+const uint8_t JOURNAL_RECORD_ORDER = 3;
+const char SNAPSHOT_FILE_MAGIC[4] = {'O', 'S', 'N', 'P'};
+const uint32_t SNAPSHOT_FILE_VERSION = 3;
+const int SNAPSHOT_INTERVAL = 1000;
+
+struct JournalOrder {
+    int orderId;
+    long long placedAt;
+    Money total;
+    string paymentMethod;
+    vector<OrderLine> lines;
+    Money discount;
+    vector<int> promotionIds;
+};
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t nextOrderId;
+    uint32_t reserved;
+    uint64_t orderCount;
+};
+
+// Append-only order journal with snapshot and archive files.
+class OrderJournal {
+private:
+    string journalPath;
+    string snapshotPath;
+    string archivePath;
+    FILE* file;
+    int recordsSinceSnapshot;
+    size_t snapshotOrders;
+    mutex lock;
+
+    template<typename T>
+    static void put(string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static bool get(const char*& data, const char* end, T& value) {
+        if (static_cast<size_t>(end - data) < sizeof(T)) return false;
+        memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    static void frame(const string& payload, string& out);
+
+    // Returns the number of bytes of valid records.
+    static size_t readRecords(const string& buffer, size_t offset,
+                              const function<void(const JournalOrder&)>& apply);
+
+    static bool readFile(const string& path, string& buffer);
+
+public:
+    explicit OrderJournal(const string& journalPath)
+        : journalPath(journalPath), snapshotPath(journalPath + ".snapshot"), archivePath(journalPath + ".archive"),
+          file(nullptr), recordsSinceSnapshot(0), snapshotOrders(0) {}
+
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+
+    ~OrderJournal() {
+        if (file != nullptr) {
+            fclose(file);
+        }
+    }
+
+    static uint32_t crc32(const char* data, size_t size);
+    static void encodeOrder(const JournalOrder& order, string& payload);
+    static bool decodeOrder(const char* data, size_t size, JournalOrder& order);
+    static void toJournalOrder(const Order& order, JournalOrder& out);
+
+    // Replays archive, snapshot and journal; returns the next order ID.
+    int recover(const function<void(const JournalOrder&)>& apply,
+                const function<void(const JournalOrder&)>& applyArchived);
+
+    // Runs publish under the journal lock once the record is written, so a
+    // snapshot cannot fall between the two.
+    void append(const Order& order, const function<void()>& publish);
+    void archive(const vector<const Order*>& orders);
+
+    // Snapshots once the journal is as large as the last snapshot.
+    void snapshotIfDue(const function<vector<const Order*>()>& gatherOrders);
+
+    void snapshot(const function<vector<const Order*>()>& gatherOrders) {
+        lock_guard<mutex> guard(lock);
+        writeSnapshot(gatherOrders);
+    }
+
+private:
+    void writeSnapshot(const function<vector<const Order*>()>& gatherOrders);
+};
+
+// ==================== CART SNAPSHOTS ====================
+// Cart file: a header, then one framed record per saved cart.
+const char CART_FILE_MAGIC[4] = {'O', 'C', 'R', 'T'};
+const uint32_t CART_FILE_VERSION = 1;
+const uint8_t CART_RECORD = 1;
+
+struct CartFileHeader {
+    char magic[4];
+    uint32_t version;
+};
+
+struct CartStoreStats {
+    unsigned long long cartsSaved;
+    unsigned long long writes;
+    unsigned long long failedWrites;
+    size_t pendingBytes;
+};
+
+// Records are appended by a writer thread.
+class CartStore {
+private:
+    static const size_t RECORD_PREFIX = 1 + 4;
+
+    string path;
+    FILE* file;
+    thread writer;
+    mutex lock;
+    condition_variable hasWork;
+    string pending;
+    bool closing;
+    atomic<unsigned long long> cartsSaved;
+    atomic<unsigned long long> writes;
+    atomic<unsigned long long> failedWrites;
+
+    static bool parseRecord(const char* payload, uint32_t length, string_view& session, uint32_t& lineCount);
+
+    static bool isValidLine(const CartItem& line) {
+        return strnlen(line.getCode(), PRODUCT_CODE_LENGTH + 1) == PRODUCT_CODE_LENGTH &&
+               line.getQuantity() > 0 && line.getUnitPrice().getCents() >= 0;
+    }
+
+    void writerLoop();
+
+public:
+    explicit CartStore(const string& path)
+        : path(path), file(nullptr), closing(false), cartsSaved(0), writes(0), failedWrites(0) {}
+
+    CartStore(const CartStore&) = delete;
+    CartStore& operator=(const CartStore&) = delete;
+
+    ~CartStore();
+    static void encodeCart(string_view session, const ShoppingCart& cart, string& out);
+
+    // Restores the newest cart of every session and compacts the file.
+    size_t recover(const function<void(string_view, const CartItem*, size_t)>& restore);
+
+    void save(string& records, size_t cartCount);
+    CartStoreStats getStats();
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "logger.h"
+
+// ==================== ORDER LOGGER ====================
+OrderLogger* OrderLogger::instance = nullptr;
+LoggerConfig OrderLogger::config;
+
+OrderLogger::OrderLogger() : logFile(nullptr), running(false), enqueued(0), written(0), dropped(0), batches(0) {
+    if (config.path.empty()) return;
+    logFile = fopen(config.path.c_str(), "a");
+    if (logFile == nullptr) {
+        throw runtime_error("Failed to open log file.");
+    }
+    if (config.async) {
+        queue.reset(new MpscRingBuffer<LogRecord>(config.queueCapacity));
+        running = true;
+        writer = thread(&OrderLogger::writerLoop, this);
+    }
+}
+
+void OrderLogger::syncToDisk() {
+#ifdef _WIN32
+    _commit(_fileno(logFile));
+#else
+    fsync(fileno(logFile));
+#endif
+}
+
+size_t OrderLogger::writeBatch(string& batch) {
+    LogRecord record;
+    char line[128];
+    size_t count = 0;
+
+    batch.clear();
+    while (count < config.maxBatchRecords && queue->tryPop(record)) {
+        int length = formatRecord(line, sizeof(line), record.orderId, record.paymentMethod);
+        batch.append(line, static_cast<size_t>(min(length, static_cast<int>(sizeof(line)) - 1)));
+        count++;
+    }
+    if (count > 0) {
+        fwrite(batch.data(), 1, batch.size(), logFile);
+        written += count;
+        batches++;
+    }
+    return count;
+}
+
+void OrderLogger::writerLoop() {
+    string batch;
+    size_t unflushed = 0;
+    auto lastFlush = chrono::steady_clock::now();
+
+    while (running.load(memory_order_acquire)) {
+        size_t count = writeBatch(batch);
+        unflushed += count;
+
+        auto now = chrono::steady_clock::now();
+        bool flushDue = unflushed > 0 && (
+            config.fsyncPerBatch ||
+            (config.flushEveryRecords > 0 && unflushed >= static_cast<size_t>(config.flushEveryRecords)) ||
+            (config.flushIntervalMs > 0 && now - lastFlush >= chrono::milliseconds(config.flushIntervalMs)));
+
+        if (flushDue) {
+            fflush(logFile);
+            if (config.fsyncPerBatch) {
+                syncToDisk();
+            }
+            unflushed = 0;
+            lastFlush = now;
+        }
+        if (count == 0) {
+            // Producers notify when they push into an empty ring.
+            unique_lock<mutex> guard(wakeLock);
+            auto ready = [this]() { return !running.load(memory_order_acquire) || !queue->empty(); };
+            if (unflushed > 0 && config.flushIntervalMs > 0) {
+                wake.wait_until(guard, lastFlush + chrono::milliseconds(config.flushIntervalMs), ready);
+            } else {
+                wake.wait(guard, ready);
+            }
+        }
+    }
+
+    while (writeBatch(batch) > 0) {}
+    fflush(logFile);
+    if (config.fsyncPerBatch) {
+        syncToDisk();
+    }
+}
+
+void OrderLogger::logOrder(int orderId, const char* paymentMethod) {
+    STORE_METRIC_SCOPE(METRIC_LOG_ORDER);
+    if (logFile == nullptr) return;
+    if (queue) {
+        LogRecord record;
+        record.orderId = orderId;
+        strncpy(record.paymentMethod, paymentMethod, MAX_PAYMENT_METHOD_LENGTH - 1);
+        record.paymentMethod[MAX_PAYMENT_METHOD_LENGTH - 1] = '\0';
+        bool wasEmpty = false;
+        if (queue->tryPush(record, wasEmpty)) {
+            enqueued++;
+            if (wasEmpty) {
+                lock_guard<mutex> guard(wakeLock);
+                wake.notify_one();
+            }
+        } else {
+            dropped++;
+        }
+        return;
+    }
+
+    char line[128];
+    int length = formatRecord(line, sizeof(line), orderId, paymentMethod);
+    fwrite(line, 1, static_cast<size_t>(min(length, static_cast<int>(sizeof(line)) - 1)), logFile);
+    fflush(logFile);
+    written++;
+}
+
+LoggerStats OrderLogger::getStats() const {
+    LoggerStats stats;
+    stats.queueDepth = queue ? queue->depth() : 0;
+    stats.enqueued = enqueued.load();
+    stats.written = written.load();
+    stats.dropped = dropped.load();
+    stats.batches = batches.load();
+    return stats;
+}
+
+OrderLogger::~OrderLogger() {
+    if (writer.joinable()) {
+        {
+            lock_guard<mutex> guard(wakeLock);
+            running.store(false, memory_order_release);
+        }
+        wake.notify_one();
+        writer.join();
+    }
+    if (logFile != nullptr) {
+        fclose(logFile);
+    }
+}
@@ -0,0 +1,161 @@
+#ifndef STORE_LOGGER_H
+#define STORE_LOGGER_H
+
+#include "money.h"
+
+// ==================== ORDER LOGGER ====================
+// Bounded lock-free multi-producer/single-consumer ring buffer.
+template<typename T>
+class MpscRingBuffer {
+private:
+    struct alignas(64) Cell {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    vector<Cell> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> enqueuePos;
+    alignas(64) atomic<size_t> dequeuePos;
+
+public:
+    explicit MpscRingBuffer(size_t capacity) : cells(capacity), mask(capacity - 1), enqueuePos(0), dequeuePos(0) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw invalid_argument("Ring buffer capacity must be a power of two");
+        }
+        for (size_t i = 0; i < capacity; i++) {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    // wasEmpty reports that the consumer had drained everything before this record.
+    bool tryPush(const T& value, bool& wasEmpty) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, memory_order_release);
+        atomic_thread_fence(memory_order_seq_cst);
+        wasEmpty = dequeuePos.load(memory_order_relaxed) == pos;
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        Cell& cell = cells[pos & mask];
+        if (cell.sequence.load(memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(pos + mask + 1, memory_order_release);
+        dequeuePos.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer side; pairs with the fence in tryPush so a push is either seen
+    // here or reported to its producer as wasEmpty.
+    bool empty() const {
+        atomic_thread_fence(memory_order_seq_cst);
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        return cells[pos & mask].sequence.load(memory_order_acquire) != pos + 1;
+    }
+
+    size_t depth() const {
+        size_t head = enqueuePos.load(memory_order_relaxed);
+        size_t tail = dequeuePos.load(memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+};
+
+// When to flush batched log records; an empty path turns logging off.
+struct LoggerConfig {
+    string path;
+    bool async;
+    size_t queueCapacity;
+    int flushEveryRecords;
+    int flushIntervalMs;
+    bool fsyncPerBatch;
+    size_t maxBatchRecords;
+
+    LoggerConfig() : path("orders.log"), async(false), queueCapacity(65536), flushEveryRecords(0),
+                     flushIntervalMs(100), fsyncPerBatch(false), maxBatchRecords(4096) {}
+};
+
+struct LoggerStats {
+    size_t queueDepth;
+    unsigned long long enqueued;
+    unsigned long long written;
+    unsigned long long dropped;
+    unsigned long long batches;
+};
+
+class OrderLogger {
+private:
+    struct LogRecord {
+        int orderId;
+        char paymentMethod[MAX_PAYMENT_METHOD_LENGTH];
+    };
+
+    static OrderLogger* instance;
+    static LoggerConfig config;
+    FILE* logFile;
+    unique_ptr<MpscRingBuffer<LogRecord>> queue;
+    thread writer;
+    mutex wakeLock;
+    condition_variable wake;
+    atomic<bool> running;
+    atomic<unsigned long long> enqueued;
+    atomic<unsigned long long> written;
+    atomic<unsigned long long> dropped;
+    atomic<unsigned long long> batches;
+
+    OrderLogger();
+
+    static int formatRecord(char* out, size_t size, int orderId, const char* paymentMethod) {
+        return snprintf(out, size, "[ORDER #%d] Paid with %s\n", orderId, paymentMethod);
+    }
+
+    void syncToDisk();
+
+    // Drains up to maxBatchRecords into one buffer and writes it with a single fwrite.
+    size_t writeBatch(string& batch);
+
+    void writerLoop();
+
+public:
+    // Must be called before the first getInstance() to take effect.
+    static void configure(const LoggerConfig& newConfig) {
+        config = newConfig;
+    }
+
+    static OrderLogger* getInstance() {
+        if (!instance) {
+            instance = new OrderLogger();
+        }
+        return instance;
+    }
+
+    static void shutdown() {
+        delete instance;
+        instance = nullptr;
+    }
+
+    void logOrder(int orderId, const char* paymentMethod);
+    LoggerStats getStats() const;
+    ~OrderLogger();
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "money.h"
+
+// ==================== MONEY ====================
+Money Money::fromUnits(long long units) {
+    long long cents;
+    if (__builtin_mul_overflow(units, 100LL, &cents)) {
+        throw overflow_error("Amount is too large");
+    }
+    return Money(cents);
+}
+
+bool Money::parse(string_view text, Money& amount) {
+    size_t pos = 0;
+    long long whole = 0;
+    long long fraction = 0;
+    int fractionDigits = 0;
+
+    if (text.empty()) return false;
+    while (pos < text.size() && isdigit(static_cast<unsigned char>(text[pos]))) {
+        if (whole > (LLONG_MAX / 100 - 9) / 10) return false;
+        whole = whole * 10 + (text[pos] - '0');
+        pos++;
+    }
+    if (pos == 0) return false;
+    if (pos < text.size() && text[pos] == '.') {
+        pos++;
+        while (pos < text.size() && isdigit(static_cast<unsigned char>(text[pos]))) {
+            if (fractionDigits == 2) return false;
+            fraction = fraction * 10 + (text[pos] - '0');
+            fractionDigits++;
+            pos++;
+        }
+    }
+    if (pos != text.size()) return false;
+    if (fractionDigits == 1) fraction *= 10;
+
+    amount = Money(whole * 100 + fraction);
+    return true;
+}
+
+Money Money::percent(int basisPoints) const {
+    __int128 scaled = static_cast<__int128>(cents) * basisPoints;
+    __int128 share = (scaled + (scaled < 0 ? -5000 : 5000)) / 10000;
+    if (share > LLONG_MAX || share < LLONG_MIN) {
+        throw overflow_error("Amount would exceed maximum value");
+    }
+    return Money(static_cast<long long>(share));
+}
+
+char* Money::format(char* first) const {
+    unsigned long long magnitude = cents < 0 ? 0ULL - static_cast<unsigned long long>(cents)
+                                             : static_cast<unsigned long long>(cents);
+    char* last = first + MAX_TEXT_LENGTH;
+    if (cents < 0) *first++ = '-';
+    first = to_chars(first, last, magnitude / 100).ptr;
+    *first++ = '.';
+    *first++ = static_cast<char>('0' + magnitude % 100 / 10);
+    *first++ = static_cast<char>('0' + magnitude % 10);
+    return first;
+}
+
+ostream& operator<<(ostream& out, const Money& amount) {
+    return out << amount.toString();
+}
+
+// ==================== METRICS ====================
+vector<MetricSummary> Metrics::summarize(vector<vector<unsigned long long>>* merged) {
+    vector<vector<unsigned long long>> buckets(METRIC_COUNT, vector<unsigned long long>(BUCKETS, 0));
+    vector<MetricSummary> summaries(METRIC_COUNT);
+    for (int id = 0; id < METRIC_COUNT; id++) {
+        summaries[id] = MetricSummary();
+        summaries[id].name = METRIC_NAMES[id];
+    }
+
+    {
+        lock_guard<mutex> guard(registryLock());
+        for (const unique_ptr<ThreadBlock>& block : registry()) {
+            for (int id = 0; id < METRIC_COUNT; id++) {
+                for (int b = 0; b < BUCKETS; b++) {
+                    buckets[id][b] += block->buckets[id][b].load(memory_order_relaxed);
+                }
+                summaries[id].sumNanos += block->sums[id].load(memory_order_relaxed);
+                summaries[id].maxNanos = max(summaries[id].maxNanos, block->maxes[id].load(memory_order_relaxed));
+            }
+        }
+    }
+
+    for (int id = 0; id < METRIC_COUNT; id++) {
+        MetricSummary& summary = summaries[id];
+        for (int b = 0; b < BUCKETS; b++) summary.count += buckets[id][b];
+        summary.p50Nanos = min(percentile(buckets[id], summary.count, 0.50), summary.maxNanos);
+        summary.p90Nanos = min(percentile(buckets[id], summary.count, 0.90), summary.maxNanos);
+        summary.p99Nanos = min(percentile(buckets[id], summary.count, 0.99), summary.maxNanos);
+    }
+    if (merged != nullptr) merged->swap(buckets);
+    return summaries;
+}
+
+void Metrics::writeJson(ostream& out) {
+    vector<MetricSummary> summaries = summarize();
+    out << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"metrics\":[";
+    for (size_t i = 0; i < summaries.size(); i++) {
+        const MetricSummary& summary = summaries[i];
+        out << (i > 0 ? "," : "") << "{\"name\":\"" << summary.name << "\""
+            << ",\"count\":" << summary.count
+            << ",\"sum_ns\":" << summary.sumNanos
+            << ",\"max_ns\":" << summary.maxNanos
+            << ",\"p50_ns\":" << summary.p50Nanos
+            << ",\"p90_ns\":" << summary.p90Nanos
+            << ",\"p99_ns\":" << summary.p99Nanos << "}";
+    }
+    out << "]}";
+}
+
+void Metrics::writePrometheus(ostream& out) {
+    vector<vector<unsigned long long>> buckets;
+    vector<MetricSummary> summaries = summarize(&buckets);
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+
+    out << "# HELP store_operation_seconds Latency of store hot-path operations.\n"
+        << "# TYPE store_operation_seconds histogram\n";
+    out << setprecision(9) << fixed;
+    for (int id = 0; id < METRIC_COUNT; id++) {
+        unsigned long long cumulative = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            if (buckets[id][b] == 0) continue;
+            cumulative += buckets[id][b];
+            out << "store_operation_seconds_bucket{op=\"" << METRIC_NAMES[id] << "\",le=\""
+                << static_cast<double>(bucketLimit(b)) / 1e9 << "\"} " << cumulative << "\n";
+        }
+        out << "store_operation_seconds_bucket{op=\"" << METRIC_NAMES[id] << "\",le=\"+Inf\"} " << summaries[id].count << "\n"
+            << "store_operation_seconds_sum{op=\"" << METRIC_NAMES[id] << "\"} "
+            << static_cast<double>(summaries[id].sumNanos) / 1e9 << "\n"
+            << "store_operation_seconds_count{op=\"" << METRIC_NAMES[id] << "\"} " << summaries[id].count << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Metrics::writeFile(const string& path) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        throw runtime_error("Failed to create metrics file.");
+    }
+    if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0) {
+        writeJson(out);
+        out << "\n";
+    } else {
+        writePrometheus(out);
+    }
+}
+
+Metrics::ThreadBlock& Metrics::local() {
+    static thread_local ThreadBlock* block = nullptr;
+    if (block == nullptr) {
+        unique_ptr<ThreadBlock> created(new ThreadBlock());
+        block = created.get();
+        lock_guard<mutex> guard(registryLock());
+        registry().push_back(move(created));
+    }
+    return *block;
+}
+
+unsigned long long Metrics::percentile(const vector<unsigned long long>& buckets, unsigned long long count, double quantile) {
+    if (count == 0) return 0;
+    unsigned long long rank = static_cast<unsigned long long>(ceil(quantile * static_cast<double>(count)));
+    unsigned long long seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= max(rank, 1ULL)) return bucketLimit(b);
+    }
+    return bucketLimit(BUCKETS - 1);
+}
@@ -0,0 +1,203 @@
+#ifndef STORE_MONEY_H
+#define STORE_MONEY_H
+
+#include "common.h"
+
+// ==================== MONEY ====================
+// Money in integer centavos; arithmetic throws overflow_error instead of wrapping.
+class Money {
+private:
+    long long cents;
+
+    explicit Money(long long cents) : cents(cents) {}
+
+public:
+    Money() : cents(0) {}
+
+    static Money fromCents(long long cents) { return Money(cents); }
+
+    static Money fromUnits(long long units);
+
+    // Parses "1499", "1499.5" or "1499.50" without floating point.
+    static bool parse(string_view text, Money& amount);
+
+    long long getCents() const { return cents; }
+
+    Money operator+(const Money& other) const {
+        long long sum;
+        if (__builtin_add_overflow(cents, other.cents, &sum)) {
+            throw overflow_error("Amount would exceed maximum value");
+        }
+        return Money(sum);
+    }
+
+    Money& operator+=(const Money& other) {
+        *this = *this + other;
+        return *this;
+    }
+
+    Money operator-(const Money& other) const {
+        long long difference;
+        if (__builtin_sub_overflow(cents, other.cents, &difference)) {
+            throw overflow_error("Amount would exceed maximum value");
+        }
+        return Money(difference);
+    }
+
+    // Share in basis points (10000 = 100%), rounded to the nearest centavo.
+    Money percent(int basisPoints) const;
+
+    Money operator*(long long quantity) const {
+        long long product;
+        if (__builtin_mul_overflow(cents, quantity, &product)) {
+            throw overflow_error("Amount would exceed maximum value");
+        }
+        return Money(product);
+    }
+
+    bool operator==(const Money& other) const { return cents == other.cents; }
+    bool operator!=(const Money& other) const { return cents != other.cents; }
+    bool operator<(const Money& other) const { return cents < other.cents; }
+
+    static const size_t MAX_TEXT_LENGTH = 24;
+    char* format(char* first) const;
+
+    string toString() const {
+        char buffer[MAX_TEXT_LENGTH];
+        return string(buffer, format(buffer));
+    }
+};
+
+ostream& operator<<(ostream& out, const Money& amount);
+
+// ==================== METRICS ====================
+// Per-thread call counters and latency histograms; -DSTORE_NO_METRICS compiles them out.
+enum MetricId {
+    METRIC_FIND_PRODUCT,
+    METRIC_CART_ADD,
+    METRIC_CHECKOUT,
+    METRIC_PAYMENT,
+    METRIC_LOG_ORDER,
+    METRIC_COUNT
+};
+
+const char* const METRIC_NAMES[METRIC_COUNT] = {
+    "find_product", "cart_add", "checkout", "payment", "log_order"
+};
+
+struct MetricSummary {
+    const char* name;
+    unsigned long long count;
+    unsigned long long sumNanos;
+    unsigned long long maxNanos;
+    unsigned long long p50Nanos;
+    unsigned long long p90Nanos;
+    unsigned long long p99Nanos;
+};
+
+class Metrics {
+public:
+    // Exact buckets below 16ns, then 8 buckets per power of two.
+    static const int LINEAR_BUCKETS = 16;
+    static const int SUB_BUCKETS = 8;
+    static const int MAX_EXPONENT = 40;
+    static const int BUCKETS = LINEAR_BUCKETS + (MAX_EXPONENT - 3) * SUB_BUCKETS;
+
+    static constexpr bool enabled() {
+#ifdef STORE_NO_METRICS
+        return false;
+#else
+        return true;
+#endif
+    }
+
+    static int bucketFor(unsigned long long nanos) {
+        if (nanos < LINEAR_BUCKETS) return static_cast<int>(nanos);
+        int exponent = 63 - __builtin_clzll(nanos);
+        if (exponent > MAX_EXPONENT) return BUCKETS - 1;
+        return LINEAR_BUCKETS + (exponent - 4) * SUB_BUCKETS + static_cast<int>((nanos >> (exponent - 3)) & (SUB_BUCKETS - 1));
+    }
+
+    static unsigned long long bucketLimit(int bucket) {
+        if (bucket < LINEAR_BUCKETS) return static_cast<unsigned long long>(bucket) + 1;
+        int exponent = 4 + (bucket - LINEAR_BUCKETS) / SUB_BUCKETS;
+        unsigned long long sub = static_cast<unsigned long long>((bucket - LINEAR_BUCKETS) % SUB_BUCKETS);
+        return (SUB_BUCKETS + sub + 1) << (exponent - 3);
+    }
+
+    static void record(MetricId id, unsigned long long nanos) {
+        ThreadBlock& block = local();
+        bump(block.buckets[id][bucketFor(nanos)], 1);
+        bump(block.sums[id], nanos);
+        if (nanos > block.maxes[id].load(memory_order_relaxed)) {
+            block.maxes[id].store(nanos, memory_order_relaxed);
+        }
+    }
+
+    // Merges every thread's block.
+    static vector<MetricSummary> summarize(vector<vector<unsigned long long>>* merged = nullptr);
+
+    static void writeJson(ostream& out);
+
+    // Prometheus text format, listing only buckets that hold samples.
+    static void writePrometheus(ostream& out);
+
+    // Writes JSON when path ends in .json and Prometheus text otherwise.
+    static void writeFile(const string& path);
+
+private:
+    struct ThreadBlock {
+        atomic<unsigned long long> buckets[METRIC_COUNT][BUCKETS];
+        atomic<unsigned long long> sums[METRIC_COUNT];
+        atomic<unsigned long long> maxes[METRIC_COUNT];
+
+        ThreadBlock() {
+            for (int id = 0; id < METRIC_COUNT; id++) {
+                for (int b = 0; b < BUCKETS; b++) buckets[id][b].store(0, memory_order_relaxed);
+                sums[id].store(0, memory_order_relaxed);
+                maxes[id].store(0, memory_order_relaxed);
+            }
+        }
+    };
+
+    // Only the owning thread writes a block.
+    static void bump(atomic<unsigned long long>& counter, unsigned long long amount) {
+        counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+
+    static vector<unique_ptr<ThreadBlock>>& registry() {
+        static vector<unique_ptr<ThreadBlock>> blocks;
+        return blocks;
+    }
+
+    static mutex& registryLock() {
+        static mutex lock;
+        return lock;
+    }
+
+    static ThreadBlock& local();
+    static unsigned long long percentile(const vector<unsigned long long>& buckets, unsigned long long count, double quantile);
+};
+
+// Times the enclosing scope into a histogram.
+class MetricScope {
+private:
+    MetricId id;
+    chrono::steady_clock::time_point started;
+
+public:
+    explicit MetricScope(MetricId id) : id(id), started(chrono::steady_clock::now()) {}
+
+    ~MetricScope() {
+        Metrics::record(id, static_cast<unsigned long long>(
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - started).count()));
+    }
+};
+
+#ifdef STORE_NO_METRICS
+#define STORE_METRIC_SCOPE(id) ((void)0)
+#else
+#define STORE_METRIC_SCOPE(id) MetricScope metricScope(id)
+#endif
+
+#endif
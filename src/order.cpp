@@ -0,0 +1,71 @@
+#include "order.h"
+
+// ==================== ORDER CLASS ====================
+atomic<int> Order::nextOrderId(1);
+
+OrderLine* OrderArena::allocate(size_t count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    if (chunks.empty() || chunkCapacity - chunkUsed < count) {
+        chunkCapacity = max(CHUNK_LINES, count);
+        chunks.emplace_back(new OrderLine[chunkCapacity]);
+        chunkUsed = 0;
+    }
+    OrderLine* lines = chunks.back().get() + chunkUsed;
+    chunkUsed += count;
+    return lines;
+}
+
+Order::Order(int orderId, const ShoppingCart& cart, PaymentStrategy* paymentStrategy, const CartPricing& pricing,
+             OrderLine* lines)
+    : orderId(orderId), lines(lines), totalAmount(pricing.getTotal()), discountAmount(pricing.discount),
+      placedAt(currentTime()) {
+    setPaymentMethod(paymentStrategy->getMethodName());
+    setPromotions(pricing.promotionIds, pricing.promotionCount);
+
+    lineCount = cart.getItemCount();
+    const CartItem* items = cart.getItems();
+    for (int i = 0; i < lineCount; i++) {
+        memcpy(lines[i].code, items[i].getCode(), PRODUCT_CODE_LENGTH + 1);
+        lines[i].quantity = items[i].getQuantity();
+        lines[i].unitPrice = items[i].getUnitPrice();
+    }
+}
+
+Order::Order(int orderId, const OrderLine* lines, int lineCount, Money totalAmount, long long placedAt,
+             const char* paymentMethod, Money discountAmount, const vector<int>& promotionIds)
+    : orderId(orderId), lineCount(lineCount), lines(lines), totalAmount(totalAmount),
+      discountAmount(discountAmount), placedAt(placedAt) {
+    setPaymentMethod(paymentMethod);
+    setPromotions(promotionIds.data(), static_cast<int>(promotionIds.size()));
+}
+
+void Order::display(RenderBuffer& screen, const ProductCatalog& catalog) const {
+    screen.add("\n╔════════════════════════════════════════════╗\n"
+               "║               ORDER SUMMARY                ║\n"
+               "╠════════════════════════════════════════════╣\n");
+    screen.add("║  Order ID: ").left(orderId, 33).add("║\n");
+    if (discountAmount.getCents() != 0) {
+        screen.add("║  Discount: PHP ").left(discountAmount, 29).add("║\n");
+    }
+    screen.add("║  Total Amount: PHP ").left(totalAmount, 25).add("║\n");
+    screen.add("║  Payment Method: ").left(paymentMethod, 27).add("║\n");
+    screen.add("╠════════════════════════════════════════════╣\n"
+               "║            ORDER DETAILS                   ║\n"
+               "╠══════════╦══════════════════════╦════════════╦══════════╗\n"
+               "║   ID     ║        Name          ║   Price    ║  Qty     ║\n"
+               "╠══════════╬══════════════════════╬════════════╬══════════╣\n");
+    
+    for (int i = 0; i < lineCount; i++) {
+        const char* name = "Unknown product";
+        int slot = catalog.getIndex().find(ProductIndex::packCode(lines[i].code));
+        if (slot >= 0) {
+            name = catalog.getProducts()[slot].getName();
+        }
+        screen.add("║ ").left(lines[i].code, 8).add(" ║ ").left(name, 20).add(" ║ ")
+              .right(lines[i].unitPrice, 10).add(" ║ ").right(lines[i].quantity, 8).add(" ║\n");
+    }
+    
+    screen.add("╚══════════╩══════════════════════╩════════════╩══════════╝\n");
+}
@@ -0,0 +1,94 @@
+#ifndef STORE_ORDER_H
+#define STORE_ORDER_H
+
+#include "cart.h"
+#include "payments.h"
+
+// ==================== ORDER CLASS ====================
+struct OrderLine {
+    char code[PRODUCT_CODE_LENGTH + 1];
+    int quantity;
+    Money unitPrice;
+};
+
+static_assert(sizeof(OrderLine) == 16, "OrderLine is expected to stay 16 bytes");
+
+// Bump allocator for order lines.
+class OrderArena {
+private:
+    static constexpr size_t CHUNK_LINES = 4096;
+    vector<unique_ptr<OrderLine[]>> chunks;
+    size_t chunkCapacity;
+    size_t chunkUsed;
+
+public:
+    OrderArena() : chunkCapacity(0), chunkUsed(0) {}
+
+    OrderArena(const OrderArena&) = delete;
+    OrderArena& operator=(const OrderArena&) = delete;
+
+    OrderLine* allocate(size_t count);
+};
+
+class Order {
+private:
+    static atomic<int> nextOrderId;
+    int orderId;
+    int lineCount;
+    const OrderLine* lines;
+    Money totalAmount;
+    Money discountAmount;
+    long long placedAt;
+    int promotionCount;
+    int promotionIds[MAX_APPLIED_PROMOTIONS];
+    char paymentMethod[MAX_PAYMENT_METHOD_LENGTH];
+
+    void setPaymentMethod(const char* method) {
+        strncpy(paymentMethod, method, MAX_PAYMENT_METHOD_LENGTH - 1);
+        paymentMethod[MAX_PAYMENT_METHOD_LENGTH - 1] = '\0';
+    }
+
+    void setPromotions(const int* ids, int count) {
+        promotionCount = min(count, MAX_APPLIED_PROMOTIONS);
+        copy(ids, ids + promotionCount, promotionIds);
+    }
+
+public:
+    // lines must have room for every cart item.
+    Order(int orderId, const ShoppingCart& cart, PaymentStrategy* paymentStrategy, const CartPricing& pricing,
+          OrderLine* lines);
+
+    Order(int orderId, const ShoppingCart& cart, PaymentStrategy* paymentStrategy, const CartPricing& pricing,
+          OrderArena& arena)
+        : Order(orderId, cart, paymentStrategy, pricing, arena.allocate(static_cast<size_t>(cart.getItemCount()))) {}
+
+    // Rebuilds a recovered order; lines must already live in an OrderArena.
+    Order(int orderId, const OrderLine* lines, int lineCount, Money totalAmount, long long placedAt,
+          const char* paymentMethod, Money discountAmount = Money(), const vector<int>& promotionIds = vector<int>());
+
+    Order(const Order& other, const OrderLine* lines) : Order(other) {
+        this->lines = lines;
+    }
+
+    static long long currentTime() {
+        return chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static int allocateOrderId() { return nextOrderId.fetch_add(1); }
+    static int getNextOrderId() { return nextOrderId.load(); }
+    static void setNextOrderId(int id) { nextOrderId.store(id); }
+
+    void display(RenderBuffer& screen, const ProductCatalog& catalog) const;
+
+    int getOrderId() const { return orderId; }
+    Money getTotalAmount() const { return totalAmount; }
+    Money getDiscountAmount() const { return discountAmount; }
+    const int* getPromotionIds() const { return promotionIds; }
+    int getPromotionCount() const { return promotionCount; }
+    long long getPlacedAt() const { return placedAt; }
+    const char* getPaymentMethod() const { return paymentMethod; }
+    const OrderLine* getLines() const { return lines; }
+    int getLineCount() const { return lineCount; }
+};
+
+#endif
@@ -0,0 +1,299 @@
+#include "order_store.h"
+
+// ==================== ORDER STORE ====================
+ScanPool::ScanPool(size_t threadCount) : stopping(false) {
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(&ScanPool::runWorker, this);
+    }
+}
+
+ScanPool::~ScanPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    hasWork.notify_all();
+    for (thread& worker : threads) {
+        worker.join();
+    }
+}
+
+void ScanPool::runWorker() {
+    unique_lock<mutex> guard(lock);
+    for (;;) {
+        hasWork.wait(guard, [this]() { return stopping || !tasks.empty(); });
+        if (tasks.empty()) return;
+        function<void()> task = move(tasks.front());
+        tasks.pop_front();
+        guard.unlock();
+        task();
+        guard.lock();
+    }
+}
+
+void ScanPool::run(size_t count, const function<void(size_t)>& body) {
+    Batch batch;
+    batch.remaining = count;
+    auto part = [&](size_t index) {
+        exception_ptr error;
+        try {
+            body(index);
+        } catch (...) {
+            error = current_exception();
+        }
+        lock_guard<mutex> guard(lock);
+        if (error && !batch.error) batch.error = error;
+        if (--batch.remaining == 0) finished.notify_all();
+    };
+
+    {
+        lock_guard<mutex> guard(lock);
+        for (size_t i = 1; i < count; i++) {
+            tasks.push_back([&part, i]() { part(i); });
+        }
+    }
+    hasWork.notify_all();
+    if (count > 0) part(0);
+
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [&batch]() { return batch.remaining == 0; });
+    if (batch.error) rethrow_exception(batch.error);
+}
+
+OrderStore::OrderSegment& OrderStore::openSegment(ShardData& data) {
+    if (data.segments.empty() || data.segments.back()->orders.size() >= SEGMENT_ORDERS) {
+        data.segments.emplace_back(new OrderSegment());
+    }
+    return *data.segments.back();
+}
+
+const Order& OrderStore::insert(ShardData& data, OrderSegment& segment, const Order& order) {
+    segment.orders.push_back(order);
+    const Order& stored = segment.orders.back();
+    if (!data.entries.empty() && stored.getPlacedAt() < data.entries.back().placedAt) {
+        data.entriesSorted = false;
+    }
+    data.entries.push_back(OrderEntry{stored.getPlacedAt(), &stored});
+    data.byId[stored.getOrderId()] = &stored;
+    return stored;
+}
+
+vector<const Order*> OrderStore::gather(const function<void(const ShardData&, vector<const Order*>&)>& scan) const {
+    size_t workers = min(scanThreads, shards.size());
+    if (size() < MIN_PARALLEL_ORDERS) workers = 1;
+
+    vector<vector<const Order*>> parts(workers);
+    auto run = [&](size_t worker) {
+        for (size_t i = worker; i < shards.size(); i += workers) {
+            lock_guard<mutex> guard(shards[i]->lock);
+            scan(shards[i]->data, parts[worker]);
+        }
+    };
+    if (workers > 1) {
+        call_once(poolStarted, [this, workers]() { pool.reset(new ScanPool(workers - 1)); });
+        pool->run(workers, run);
+    } else {
+        run(0);
+    }
+
+    vector<const Order*> all;
+    for (const vector<const Order*>& part : parts) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    sort(all.begin(), all.end(), [](const Order* a, const Order* b) {
+        return a->getOrderId() < b->getOrderId();
+    });
+    return all;
+}
+
+const Order& OrderStore::add(const Order& placed) {
+    Shard& shard = shardFor(placed.getOrderId());
+
+    lock_guard<mutex> guard(shard.lock);
+    OrderSegment& segment = openSegment(shard.data);
+    OrderLine* lines = segment.arena.allocate(static_cast<size_t>(placed.getLineCount()));
+    copy(placed.getLines(), placed.getLines() + placed.getLineCount(), lines);
+    const Order& stored = insert(shard.data, segment, Order(placed, lines));
+    orderCount++;
+    return stored;
+}
+
+const Order& OrderStore::restore(const JournalOrder& recovered) {
+    Shard& shard = shardFor(recovered.orderId);
+
+    lock_guard<mutex> guard(shard.lock);
+    OrderSegment& segment = openSegment(shard.data);
+    OrderLine* lines = segment.arena.allocate(recovered.lines.size());
+    copy(recovered.lines.begin(), recovered.lines.end(), lines);
+    const Order& stored = insert(shard.data, segment,
+                                 Order(recovered.orderId, lines, static_cast<int>(recovered.lines.size()),
+                                       recovered.total, recovered.placedAt, recovered.paymentMethod.c_str(),
+                                       recovered.discount, recovered.promotionIds));
+    orderCount++;
+    return stored;
+}
+
+vector<const Order*> OrderStore::collect() const {
+    return gather([](const ShardData& data, vector<const Order*>& out) {
+        for (const OrderEntry& entry : data.entries) {
+            out.push_back(entry.order);
+        }
+    });
+}
+
+vector<const Order*> OrderStore::findBetween(long long from, long long to) const {
+    return gather([from, to](const ShardData& data, vector<const Order*>& out) {
+        if (!data.entriesSorted) {
+            for (const OrderEntry& entry : data.entries) {
+                if (entry.placedAt >= from && entry.placedAt < to) out.push_back(entry.order);
+            }
+            return;
+        }
+        deque<OrderEntry>::const_iterator it = lower_bound(data.entries.begin(), data.entries.end(), from,
+            [](const OrderEntry& entry, long long time) { return entry.placedAt < time; });
+        for (; it != data.entries.end() && it->placedAt < to; ++it) {
+            out.push_back(it->order);
+        }
+    });
+}
+
+vector<const Order*> OrderStore::findExpired(const OrderRetention& retention, long long now) const {
+    // IDs up to lastOverflowId push the store past maxOrders.
+    int lastOverflowId = 0;
+    size_t count = size();
+    if (retention.maxOrders > 0 && count > retention.maxOrders) {
+        vector<int> ids;
+        ids.reserve(count);
+        for (const unique_ptr<Shard>& shard : shards) {
+            lock_guard<mutex> guard(shard->lock);
+            for (const OrderEntry& entry : shard->data.entries) {
+                ids.push_back(entry.order->getOrderId());
+            }
+        }
+        if (ids.size() > retention.maxOrders) {
+            size_t overflow = ids.size() - retention.maxOrders;
+            nth_element(ids.begin(), ids.begin() + static_cast<ptrdiff_t>(overflow - 1), ids.end());
+            lastOverflowId = ids[overflow - 1];
+        }
+    }
+    long long oldest = retention.maxAgeSeconds > 0 ? now - retention.maxAgeSeconds : LLONG_MIN;
+
+    return gather([lastOverflowId, oldest](const ShardData& data, vector<const Order*>& out) {
+        for (const OrderEntry& entry : data.entries) {
+            if (entry.order->getOrderId() > lastOverflowId && entry.placedAt >= oldest) break;
+            out.push_back(entry.order);
+        }
+    });
+}
+
+void OrderStore::evict(const vector<int>& sortedIds) {
+    vector<unique_ptr<OrderSegment>> retired;
+    size_t evicted = 0;
+    for (unique_ptr<Shard>& shard : shards) {
+        lock_guard<mutex> guard(shard->lock);
+        ShardData& data = shard->data;
+        while (!data.entries.empty() &&
+               binary_search(sortedIds.begin(), sortedIds.end(), data.entries.front().order->getOrderId())) {
+            data.byId.erase(data.entries.front().order->getOrderId());
+            data.entries.pop_front();
+            evicted++;
+            // A segment is freed once all of its orders are gone.
+            if (++data.headEvicted == data.segments.front()->orders.size()) {
+                retired.push_back(move(data.segments.front()));
+                data.segments.pop_front();
+                data.headEvicted = 0;
+            }
+        }
+    }
+    orderCount -= evicted;
+    ReadEpochs::synchronize();
+}
+
+// ==================== SALES ANALYTICS ====================
+size_t SalesAnalytics::methodIdFor(const char* method) {
+    for (size_t i = 0; i < methods.size(); i++) {
+        if (methods[i].method == method) return i;
+    }
+    MethodSales entry;
+    entry.method = method;
+    entry.orders = 0;
+    methods.push_back(entry);
+    return methods.size() - 1;
+}
+
+void SalesAnalytics::record(const Order& order) {
+    lock_guard<mutex> guard(lock);
+
+    for (int i = 0; i < order.getLineCount(); i++) {
+        const OrderLine& line = order.getLines()[i];
+        uint32_t key = ProductIndex::packCode(line.code);
+        int slot = skuIndex.find(key);
+        if (slot < 0) {
+            SkuTotals totals;
+            memcpy(totals.code, line.code, sizeof(totals.code));
+            totals.units = 0;
+            slot = static_cast<int>(skus.size());
+            skus.push_back(totals);
+            skuIndex.insert(key, slot);
+        } else {
+            skusByRevenue.erase(make_pair(skus[slot].grossRevenue.getCents(), key));
+        }
+        skus[slot].units += line.quantity;
+        skus[slot].grossRevenue += line.unitPrice * line.quantity;
+        skusByRevenue.insert(make_pair(skus[slot].grossRevenue.getCents(), key));
+    }
+
+    size_t methodId = methodIdFor(order.getPaymentMethod());
+    methods[methodId].orders++;
+    methods[methodId].netRevenue += order.getTotalAmount();
+
+    // Version 1 journal orders have no placement time.
+    if (order.getPlacedAt() > 0) {
+        timeline.record(bucketOf(order.getPlacedAt()), order.getTotalAmount().getCents());
+    }
+
+    placedAtColumn.push_back(order.getPlacedAt());
+    totalColumn.push_back(order.getTotalAmount().getCents());
+}
+
+vector<ProductSales> SalesAnalytics::topProducts(size_t k) const {
+    lock_guard<mutex> guard(lock);
+    vector<ProductSales> top;
+    for (const pair<long long, uint32_t>& entry : skusByRevenue) {
+        if (top.size() >= k) break;
+        const SkuTotals& totals = skus[skuIndex.find(entry.second)];
+        ProductSales sales;
+        memcpy(sales.code, totals.code, sizeof(sales.code));
+        sales.units = totals.units;
+        sales.grossRevenue = totals.grossRevenue;
+        top.push_back(sales);
+    }
+    return top;
+}
+
+RangeSales SalesAnalytics::salesBetween(long long from, long long to) const {
+    lock_guard<mutex> guard(lock);
+    long long cents, count;
+    timeline.sum(bucketOf(from), bucketOf(to - 1) + 1, cents, count);
+    RangeSales sales;
+    sales.orders = static_cast<unsigned long long>(count);
+    sales.netRevenue = Money::fromCents(cents);
+    return sales;
+}
+
+RangeSales SalesAnalytics::scanBetween(long long from, long long to) const {
+    lock_guard<mutex> guard(lock);
+    const long long* placedAt = placedAtColumn.data();
+    const long long* totals = totalColumn.data();
+    long long cents = 0;
+    long long count = 0;
+    for (size_t i = 0; i < placedAtColumn.size(); i++) {
+        long long inside = (placedAt[i] >= from) & (placedAt[i] < to);
+        cents += totals[i] * inside;
+        count += inside;
+    }
+    RangeSales sales;
+    sales.orders = static_cast<unsigned long long>(count);
+    sales.netRevenue = Money::fromCents(cents);
+    return sales;
+}
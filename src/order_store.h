@@ -0,0 +1,265 @@
+#ifndef STORE_ORDER_STORE_H
+#define STORE_ORDER_STORE_H
+
+#include "journal.h"
+
+// ==================== ORDER STORE ====================
+// Zero disables a limit.
+struct OrderRetention {
+    long long maxAgeSeconds;
+    size_t maxOrders;
+
+    OrderRetention() : maxAgeSeconds(0), maxOrders(0) {}
+
+    bool isEnabled() const { return maxAgeSeconds > 0 || maxOrders > 0; }
+};
+
+// Fixed threads that run the parts of a scan alongside the caller.
+class ScanPool {
+private:
+    struct Batch {
+        size_t remaining;
+        exception_ptr error;
+    };
+
+    vector<thread> threads;
+    deque<function<void()>> tasks;
+    mutex lock;
+    condition_variable hasWork;
+    condition_variable finished;
+    bool stopping;
+
+    void runWorker();
+
+public:
+    explicit ScanPool(size_t threadCount);
+    ~ScanPool();
+
+    ScanPool(const ScanPool&) = delete;
+    ScanPool& operator=(const ScanPool&) = delete;
+
+    // Calls body(0) to body(count - 1), the caller taking part 0.
+    void run(size_t count, const function<void(size_t)>& body);
+};
+
+// Orders sharded by order ID, each shard with its own lock. A shard keeps its
+// orders in segments, each with its own arena, so eviction drops a prefix.
+class OrderStore {
+private:
+    struct OrderEntry {
+        long long placedAt;
+        const Order* order;
+    };
+
+    struct OrderSegment {
+        OrderArena arena;
+        deque<Order> orders;
+    };
+
+    struct ShardData {
+        deque<unique_ptr<OrderSegment>> segments;
+        size_t headEvicted = 0;
+        deque<OrderEntry> entries;
+        unordered_map<int, const Order*> byId;
+        bool entriesSorted = true;
+    };
+
+    struct alignas(64) Shard {
+        mutable mutex lock;
+        ShardData data;
+    };
+
+    static const size_t MIN_PARALLEL_ORDERS = 65536;
+    static const size_t SEGMENT_ORDERS = 4096;
+
+    vector<unique_ptr<Shard>> shards;
+    size_t scanThreads;
+    atomic<size_t> orderCount;
+    mutable once_flag poolStarted;
+    mutable unique_ptr<ScanPool> pool;
+
+    Shard& shardFor(int orderId) {
+        return *shards[static_cast<size_t>(orderId) % shards.size()];
+    }
+
+    static OrderSegment& openSegment(ShardData& data);
+    static const Order& insert(ShardData& data, OrderSegment& segment, const Order& order);
+    vector<const Order*> gather(const function<void(const ShardData&, vector<const Order*>&)>& scan) const;
+
+public:
+    explicit OrderStore(size_t shardCount, size_t scanThreads = max(thread::hardware_concurrency(), 1u))
+        : scanThreads(max(scanThreads, static_cast<size_t>(1))), orderCount(0) {
+        for (size_t i = 0; i < max(shardCount, static_cast<size_t>(1)); i++) {
+            shards.emplace_back(new Shard());
+        }
+    }
+
+    // Copies the order and its lines into the store.
+    const Order& add(const Order& placed);
+    const Order& restore(const JournalOrder& recovered);
+
+    size_t size() const { return orderCount.load(); }
+
+    const Order* find(int orderId) const {
+        const Shard& shard = *shards[static_cast<size_t>(orderId) % shards.size()];
+        lock_guard<mutex> guard(shard.lock);
+        unordered_map<int, const Order*>::const_iterator it = shard.data.byId.find(orderId);
+        return it != shard.data.byId.end() ? it->second : nullptr;
+    }
+
+    vector<const Order*> collect() const;
+
+    // Orders placed in [from, to), sorted by order ID.
+    vector<const Order*> findBetween(long long from, long long to) const;
+
+    // Expired orders from the front of each shard, sorted by order ID. An old
+    // order stays until the newer ones ahead of it in its shard expire too.
+    vector<const Order*> findExpired(const OrderRetention& retention, long long now) const;
+
+    // Drops the sorted IDs from the front of each shard. Must not be called
+    // inside a read section.
+    void evict(const vector<int>& sortedIds);
+};
+
+// ==================== SALES ANALYTICS ====================
+struct ProductSales {
+    char code[PRODUCT_CODE_LENGTH + 1];
+    long long units;
+    Money grossRevenue;  // list price before discounts
+};
+
+struct MethodSales {
+    string method;
+    unsigned long long orders;
+    Money netRevenue;  // order totals after discounts
+};
+
+struct RangeSales {
+    unsigned long long orders;
+    Money netRevenue;
+};
+
+// Sales aggregates kept up to date as orders are recorded.
+class SalesAnalytics {
+public:
+    static const long long BUCKET_SECONDS = 3600;
+
+private:
+    struct SkuTotals {
+        char code[PRODUCT_CODE_LENGTH + 1];
+        long long units;
+        Money grossRevenue;
+    };
+
+    // Hourly prefix sums that grow by doubling.
+    class FenwickTimeline {
+    private:
+        long long baseBucket;
+        vector<long long> revenue;
+        vector<long long> orders;
+        vector<long long> treeRevenue;
+        vector<long long> treeOrders;
+
+        static void add(vector<long long>& tree, size_t position, long long amount) {
+            for (size_t i = position + 1; i <= tree.size(); i += i & (0 - i)) {
+                tree[i - 1] += amount;
+            }
+        }
+
+        static long long prefix(const vector<long long>& tree, size_t count) {
+            long long sum = 0;
+            for (size_t i = min(count, tree.size()); i > 0; i -= i & (0 - i)) {
+                sum += tree[i - 1];
+            }
+            return sum;
+        }
+
+        void cover(long long bucket) {
+            if (revenue.empty()) {
+                baseBucket = bucket;
+                revenue.assign(64, 0);
+                orders.assign(64, 0);
+            } else if (bucket >= baseBucket && bucket < baseBucket + static_cast<long long>(revenue.size())) {
+                return;
+            } else {
+                long long first = min(baseBucket, bucket);
+                long long last = max(baseBucket + static_cast<long long>(revenue.size()), bucket + 1);
+                size_t span = max(static_cast<size_t>(last - first), revenue.size() * 2);
+                vector<long long> newRevenue(span, 0), newOrders(span, 0);
+                for (size_t i = 0; i < revenue.size(); i++) {
+                    newRevenue[static_cast<size_t>(baseBucket - first) + i] = revenue[i];
+                    newOrders[static_cast<size_t>(baseBucket - first) + i] = orders[i];
+                }
+                baseBucket = first;
+                revenue.swap(newRevenue);
+                orders.swap(newOrders);
+            }
+
+            treeRevenue.assign(revenue.size(), 0);
+            treeOrders.assign(orders.size(), 0);
+            for (size_t i = 0; i < revenue.size(); i++) {
+                if (revenue[i] != 0) add(treeRevenue, i, revenue[i]);
+                if (orders[i] != 0) add(treeOrders, i, orders[i]);
+            }
+        }
+
+        size_t clampedOffset(long long bucket) const {
+            if (bucket <= baseBucket) return 0;
+            return static_cast<size_t>(min(bucket - baseBucket, static_cast<long long>(revenue.size())));
+        }
+
+    public:
+        FenwickTimeline() : baseBucket(0) {}
+
+        void record(long long bucket, long long cents) {
+            cover(bucket);
+            size_t offset = static_cast<size_t>(bucket - baseBucket);
+            revenue[offset] += cents;
+            orders[offset]++;
+            add(treeRevenue, offset, cents);
+            add(treeOrders, offset, 1);
+        }
+
+        void sum(long long fromBucket, long long toBucket, long long& cents, long long& count) const {
+            cents = 0;
+            count = 0;
+            if (revenue.empty() || toBucket <= fromBucket) return;
+            size_t from = clampedOffset(fromBucket);
+            size_t to = clampedOffset(toBucket);
+            cents = prefix(treeRevenue, to) - prefix(treeRevenue, from);
+            count = prefix(treeOrders, to) - prefix(treeOrders, from);
+        }
+    };
+
+    mutable mutex lock;
+    vector<SkuTotals> skus;
+    ProductIndex skuIndex;
+    set<pair<long long, uint32_t>, greater<pair<long long, uint32_t>>> skusByRevenue;
+    vector<MethodSales> methods;
+    FenwickTimeline timeline;
+
+    vector<long long> placedAtColumn;
+    vector<long long> totalColumn;
+
+    static long long bucketOf(long long seconds) {
+        return seconds >= 0 ? seconds / BUCKET_SECONDS : (seconds - BUCKET_SECONDS + 1) / BUCKET_SECONDS;
+    }
+
+    size_t methodIdFor(const char* method);
+
+public:
+    void record(const Order& order);
+    vector<ProductSales> topProducts(size_t k) const;
+
+    vector<MethodSales> revenueByMethod() const {
+        lock_guard<mutex> guard(lock);
+        return methods;
+    }
+
+    // Rounded outward to whole hours.
+    RangeSales salesBetween(long long from, long long to) const;
+
+    RangeSales scanBetween(long long from, long long to) const;
+};
+
+#endif
@@ -0,0 +1,377 @@
+#include "payments.h"
+
+// ==================== PAYMENT STRATEGY ====================
+void CashPayment::pay(Money amount, ostream& out) {
+    out << "╔════════════════════════════════════════════╗\n";
+    out << "║          💵 PAYMENT SUCCESSFUL!           ║\n";
+    out << "╠════════════════════════════════════════════╣\n";
+    out << "║  Method: Cash                              ║\n";
+    out << "║  Amount: PHP " << left << setw(30) << amount << "║\n";
+    out << "╚════════════════════════════════════════════╝\n";
+}
+
+void CardPayment::pay(Money amount, ostream& out) {
+    out << "╔════════════════════════════════════════════╗\n";
+    out << "║          💳 PAYMENT SUCCESSFUL!           ║\n";
+    out << "╠════════════════════════════════════════════╣\n";
+    out << "║  Method: Credit/Debit Card                 ║\n";
+    out << "║  Amount: PHP " << left << setw(30) << amount << "║\n";
+    out << "╚════════════════════════════════════════════╝\n";
+}
+
+void GCashPayment::pay(Money amount, ostream& out) {
+    out << "╔════════════════════════════════════════════╗\n";
+    out << "║          📱 PAYMENT SUCCESSFUL!           ║\n";
+    out << "╠════════════════════════════════════════════╣\n";
+    out << "║  Method: GCash                             ║\n";
+    out << "║  Amount: PHP " << left << setw(30) << amount << "║\n";
+    out << "╚════════════════════════════════════════════╝\n";
+}
+
+// ==================== PAYMENT GATEWAY ====================
+const char* paymentStatusName(PaymentStatus status) {
+    switch (status) {
+        case PaymentStatus::Approved: return "approved";
+        case PaymentStatus::Declined: return "declined";
+        case PaymentStatus::Failed: return "failed";
+        default: return "timed_out";
+    }
+}
+
+PaymentStatus MockPaymentGateway::charge(const string& idempotencyKey, Money amount,
+                                         chrono::steady_clock::time_point deadline, bool& replayed) {
+    replayed = false;
+    {
+        lock_guard<mutex> guard(lock);
+        pair<unordered_map<string, Charge>::iterator, bool> claimed =
+            charges.emplace(idempotencyKey, Charge{amount, false});
+        if (!claimed.second) {
+            if (!claimed.first->second.captured) return PaymentStatus::Failed;
+            replays.fetch_add(1, memory_order_relaxed);
+            replayed = true;
+            return claimed.first->second.amount == amount ? PaymentStatus::Approved : PaymentStatus::Declined;
+        }
+    }
+
+    long long latency = config.latencyMicros;
+    if (latency > 0) {
+        latency = uniform_int_distribution<long long>(latency / 2, latency + latency / 2)(random());
+    }
+    chrono::steady_clock::time_point finished = chrono::steady_clock::now() + chrono::microseconds(latency);
+
+    if (config.failureRate > 0.0 && uniform_real_distribution<double>(0.0, 1.0)(random()) < config.failureRate) {
+        this_thread::sleep_until(min(finished, deadline));
+        injectedFailures.fetch_add(1, memory_order_relaxed);
+        lock_guard<mutex> guard(lock);
+        charges.erase(idempotencyKey);
+        return PaymentStatus::Failed;
+    }
+
+    this_thread::sleep_until(min(finished, deadline));
+    {
+        lock_guard<mutex> guard(lock);
+        charges[idempotencyKey].captured = true;
+    }
+    capturedCount.fetch_add(1, memory_order_relaxed);
+    if (finished > deadline) {
+        timeouts.fetch_add(1, memory_order_relaxed);
+        return PaymentStatus::TimedOut;
+    }
+    return PaymentStatus::Approved;
+}
+
+bool MockPaymentGateway::refund(const string& idempotencyKey, Money amount) {
+    lock_guard<mutex> guard(lock);
+    unordered_map<string, Charge>::iterator it = charges.find(idempotencyKey);
+    if (it == charges.end() || !it->second.captured || it->second.amount != amount) {
+        return false;
+    }
+    // A retry under the same key charges again.
+    charges.erase(it);
+    refunds.fetch_add(1, memory_order_relaxed);
+    return true;
+}
+
+MockGatewayStats MockPaymentGateway::getStats() {
+    MockGatewayStats stats;
+    stats.captured = capturedCount.load(memory_order_relaxed);
+    stats.replayed = replays.load(memory_order_relaxed);
+    stats.injectedFailures = injectedFailures.load(memory_order_relaxed);
+    stats.timeouts = timeouts.load(memory_order_relaxed);
+    stats.refunded = refunds.load(memory_order_relaxed);
+    return stats;
+}
+
+void PaymentPipeline::runWorker() {
+    unique_lock<mutex> guard(lock);
+    for (;;) {
+        hasWork.wait(guard, [this]() { return stopping || !ready.empty(); });
+        if (ready.empty()) return;
+        JobPtr job = move(ready.front());
+        ready.pop_front();
+        if (job->answered.load(memory_order_acquire)) continue;
+        job->running = true;
+        guard.unlock();
+
+        bool replayed = false;
+        PaymentStatus status;
+        try {
+            status = job->call(job->deadline, replayed);
+        } catch (const exception&) {
+            status = PaymentStatus::Failed;
+        }
+        answer(*job, status, replayed);
+
+        guard.lock();
+        job->running = false;
+        if (job->abandoned) {
+            stuckWorkers--;
+            if (activeWorkers >= threadCount) {
+                exited.push_back(this_thread::get_id());
+                timerWake.notify_one();
+                return;
+            }
+            activeWorkers++;
+        }
+    }
+}
+
+void PaymentPipeline::runTimer() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+        if (!exited.empty()) {
+            vector<thread> finished;
+            for (thread::id id : exited) {
+                auto worker = workers.find(id);
+                finished.push_back(move(worker->second));
+                workers.erase(worker);
+            }
+            exited.clear();
+            guard.unlock();
+            for (thread& worker : finished) {
+                worker.join();
+            }
+            guard.lock();
+            continue;
+        }
+
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        bool released = false;
+        while (!delayed.empty() && delayed.top()->startAt <= now) {
+            ready.push_back(delayed.top());
+            delayed.pop();
+            released = true;
+        }
+        if (released) hasWork.notify_all();
+
+        vector<JobPtr> expired;
+        while (!watched.empty() && watched.top()->deadline <= now) {
+            JobPtr job = watched.top();
+            watched.pop();
+            if (job->answered.load(memory_order_acquire)) continue;
+            if (job->running) {
+                // At most threadCount replacements, so a hung gateway cannot grow the pool.
+                job->abandoned = true;
+                activeWorkers--;
+                if (++stuckWorkers <= threadCount) startWorker();
+            }
+            expired.push_back(move(job));
+        }
+        if (!expired.empty()) {
+            guard.unlock();
+            for (const JobPtr& job : expired) {
+                answer(*job, PaymentStatus::TimedOut, false);
+            }
+            guard.lock();
+            continue;
+        }
+
+        if (watched.empty() && delayed.empty()) {
+            timerWake.wait(guard);
+        } else {
+            chrono::steady_clock::time_point wake = chrono::steady_clock::time_point::max();
+            if (!watched.empty()) wake = watched.top()->deadline;
+            if (!delayed.empty()) wake = min(wake, delayed.top()->startAt);
+            timerWake.wait_until(guard, wake);
+        }
+    }
+}
+
+PaymentPipeline::~PaymentPipeline() {
+    vector<JobPtr> unstarted;
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+        unstarted.assign(ready.begin(), ready.end());
+        ready.clear();
+        while (!delayed.empty()) {
+            unstarted.push_back(delayed.top());
+            delayed.pop();
+        }
+    }
+    hasWork.notify_all();
+    timerWake.notify_all();
+    if (timer.joinable()) timer.join();
+    for (const JobPtr& job : unstarted) {
+        answer(*job, PaymentStatus::Failed, false);
+    }
+    for (auto& worker : workers) {
+        worker.second.join();
+    }
+}
+
+void PaymentPipeline::schedule(Call call, Completion done, chrono::steady_clock::time_point startAt, chrono::milliseconds timeout) {
+    JobPtr job = make_shared<Job>(move(call), move(done), startAt, startAt + timeout);
+    {
+        lock_guard<mutex> guard(lock);
+        if (!stopping) {
+            if (!timer.joinable()) {
+                for (size_t i = 0; i < threadCount; i++) {
+                    startWorker();
+                }
+                timer = thread(&PaymentPipeline::runTimer, this);
+            }
+            watched.push(job);
+            if (startAt <= chrono::steady_clock::now()) {
+                ready.push_back(job);
+            } else {
+                delayed.push(job);
+            }
+            job = nullptr;
+        }
+    }
+    if (job) {
+        answer(*job, PaymentStatus::Failed, false);
+        return;
+    }
+    hasWork.notify_one();
+    timerWake.notify_one();
+}
+
+// ==================== PAYMENT REGISTRY ====================
+void PaymentRegistry::attempt(shared_ptr<Authorization> authorization, chrono::steady_clock::time_point startAt) {
+    authorization->result.attempts++;
+    pipeline.schedule(
+        [authorization](chrono::steady_clock::time_point deadline, bool& replayed) {
+            return authorization->provider->gateway->charge(authorization->key, authorization->amount, deadline, replayed);
+        },
+        [this, authorization](PaymentStatus status, bool replayed) {
+            Provider& provider = *authorization->provider;
+            PaymentResult& result = authorization->result;
+            result.status = status;
+            result.replayed = replayed;
+            if (status != PaymentStatus::Approved && status != PaymentStatus::Declined &&
+                result.attempts < max(provider.policy.maxAttempts, 1)) {
+                provider.retries.fetch_add(1, memory_order_relaxed);
+                attempt(authorization, chrono::steady_clock::now() +
+                                           chrono::milliseconds(provider.policy.retryBackoffMs << min(result.attempts - 1, 6)));
+                return;
+            }
+            record(provider, result, authorization->started);
+            authorization->settled.set_value(result);
+            if (authorization->notify) authorization->notify();
+        },
+        startAt, chrono::milliseconds(authorization->provider->policy.timeoutMs));
+}
+
+void PaymentRegistry::record(Provider& provider, const PaymentResult& result, chrono::steady_clock::time_point started) {
+    long long micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - started).count();
+    provider.payments.fetch_add(1, memory_order_relaxed);
+    if (result.status != PaymentStatus::Approved) {
+        provider.failures.fetch_add(1, memory_order_relaxed);
+    }
+    provider.totalMicros.fetch_add(micros, memory_order_relaxed);
+    long long seen = provider.maxMicros.load(memory_order_relaxed);
+    while (micros > seen && !provider.maxMicros.compare_exchange_weak(seen, micros, memory_order_relaxed)) {}
+}
+
+void PaymentRegistry::registerProvider(int id, const char* icon, unique_ptr<PaymentStrategy> strategy,
+                                       shared_ptr<PaymentGateway> gateway, const PaymentPolicy& policy) {
+    if (id <= 0 || id > MAX_PROVIDER_ID || !strategy) {
+        throw invalid_argument("Invalid payment provider");
+    }
+    if (lookup(id) != nullptr) {
+        throw invalid_argument("Payment method ID already registered");
+    }
+    if (byId.size() <= static_cast<size_t>(id)) {
+        byId.resize(id + 1, nullptr);
+    }
+    providers.emplace_back(new Provider(id, icon, move(strategy), move(gateway), policy));
+    byId[id] = providers.back().get();
+}
+
+Result<const char*> PaymentRegistry::lookupMethodName(int id) const {
+    Provider* provider = lookup(id);
+    if (provider == nullptr) {
+        return StoreError::InvalidInput;
+    }
+    return provider->strategy->getMethodName();
+}
+
+future<PaymentResult> PaymentRegistry::authorize(int id, Money amount, int orderId, function<void()> notify) {
+    Provider* provider = lookup(id);
+    if (provider == nullptr) {
+        throw InvalidInputException();
+    }
+
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    if (!provider->gateway) {
+        promise<PaymentResult> settled;
+        PaymentResult result;
+        result.status = PaymentStatus::Approved;
+        result.attempts = 1;
+        record(*provider, result, started);
+        settled.set_value(result);
+        if (notify) notify();
+        return settled.get_future();
+    }
+
+    shared_ptr<Authorization> authorization = make_shared<Authorization>();
+    authorization->provider = provider;
+    authorization->amount = amount;
+    authorization->key = idempotencyKey(orderId);
+    authorization->started = started;
+    authorization->notify = move(notify);
+    future<PaymentResult> result = authorization->settled.get_future();
+    attempt(authorization, started);
+    return result;
+}
+
+PaymentStrategy& PaymentRegistry::settle(int id, Money amount, const PaymentResult& result, ostream* receipt) {
+    switch (result.status) {
+        case PaymentStatus::Approved: break;
+        case PaymentStatus::Declined: throw PaymentFailedException("Payment was declined.");
+        case PaymentStatus::TimedOut: throw PaymentFailedException("Payment timed out. Please try again.");
+        default: throw PaymentFailedException("Payment failed. Please try again.");
+    }
+
+    PaymentStrategy& strategy = *lookup(id)->strategy;
+    if (receipt != nullptr) {
+        strategy.pay(amount, *receipt);
+    }
+    return strategy;
+}
+
+bool PaymentRegistry::refund(int id, Money amount, int orderId) {
+    Provider* provider = lookup(id);
+    if (provider == nullptr) return false;
+    // Without a gateway no money left the till.
+    if (!provider->gateway) return true;
+    return provider->gateway->refund(idempotencyKey(orderId), amount);
+}
+
+vector<PaymentProviderStats> PaymentRegistry::getStats() const {
+    vector<PaymentProviderStats> stats;
+    for (const unique_ptr<Provider>& provider : providers) {
+        PaymentProviderStats entry;
+        entry.id = provider->id;
+        entry.method = provider->strategy->getMethodName();
+        entry.payments = provider->payments.load(memory_order_relaxed);
+        entry.failures = provider->failures.load(memory_order_relaxed);
+        entry.retries = provider->retries.load(memory_order_relaxed);
+        entry.totalMicros = provider->totalMicros.load(memory_order_relaxed);
+        entry.maxMicros = provider->maxMicros.load(memory_order_relaxed);
+        stats.push_back(entry);
+    }
+    return stats;
+}
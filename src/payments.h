@@ -0,0 +1,287 @@
+#ifndef STORE_PAYMENTS_H
+#define STORE_PAYMENTS_H
+
+#include "money.h"
+
+// ==================== PAYMENT STRATEGY ====================
+class PaymentStrategy {
+public:
+    virtual ~PaymentStrategy() {}
+    virtual void pay(Money amount, ostream& out) = 0;
+    virtual const char* getMethodName() const = 0;
+};
+
+class CashPayment : public PaymentStrategy {
+public:
+    void pay(Money amount, ostream& out) override;
+    const char* getMethodName() const override { return "Cash"; }
+};
+
+class CardPayment : public PaymentStrategy {
+public:
+    void pay(Money amount, ostream& out) override;
+    const char* getMethodName() const override { return "Credit/Debit Card"; }
+};
+
+class GCashPayment : public PaymentStrategy {
+public:
+    void pay(Money amount, ostream& out) override;
+    const char* getMethodName() const override { return "GCash"; }
+};
+
+// ==================== PAYMENT GATEWAY ====================
+enum class PaymentStatus { Approved, Declined, Failed, TimedOut };
+
+const char* paymentStatusName(PaymentStatus status);
+
+struct PaymentResult {
+    PaymentStatus status;
+    int attempts;
+    bool replayed;
+
+    PaymentResult() : status(PaymentStatus::Failed), attempts(0), replayed(false) {}
+};
+
+// Remote side of a payment provider; a repeated idempotency key is a replay.
+class PaymentGateway {
+public:
+    virtual ~PaymentGateway() {}
+    virtual PaymentStatus charge(const string& idempotencyKey, Money amount,
+                                 chrono::steady_clock::time_point deadline, bool& replayed) = 0;
+
+    // Returns false if no charge for amount was captured under the key.
+    virtual bool refund(const string& idempotencyKey, Money amount) = 0;
+};
+
+struct MockGatewayConfig {
+    int latencyMicros = 0;
+    double failureRate = 0.0;
+};
+
+struct MockGatewayStats {
+    unsigned long long captured;
+    unsigned long long replayed;
+    unsigned long long injectedFailures;
+    unsigned long long timeouts;
+    unsigned long long refunded;
+};
+
+// In-process gateway for offline load tests.
+class MockPaymentGateway : public PaymentGateway {
+private:
+    struct Charge {
+        Money amount;
+        bool captured;
+    };
+
+    MockGatewayConfig config;
+    mutex lock;
+    unordered_map<string, Charge> charges;
+    atomic<unsigned long long> capturedCount;
+    atomic<unsigned long long> replays;
+    atomic<unsigned long long> injectedFailures;
+    atomic<unsigned long long> timeouts;
+    atomic<unsigned long long> refunds;
+
+    static mt19937& random() {
+        static thread_local mt19937 generator(random_device{}());
+        return generator;
+    }
+
+public:
+    explicit MockPaymentGateway(const MockGatewayConfig& config)
+        : config(config), capturedCount(0), replays(0), injectedFailures(0), timeouts(0), refunds(0) {}
+
+    PaymentStatus charge(const string& idempotencyKey, Money amount,
+                         chrono::steady_clock::time_point deadline, bool& replayed) override;
+    bool refund(const string& idempotencyKey, Money amount) override;
+
+    MockGatewayStats getStats();
+};
+
+struct PaymentPolicy {
+    int timeoutMs = 2000;
+    int maxAttempts = 3;
+    int retryBackoffMs = 5;
+};
+
+// Runs gateway calls off the checkout thread and enforces their deadlines.
+class PaymentPipeline {
+public:
+    typedef function<PaymentStatus(chrono::steady_clock::time_point deadline, bool& replayed)> Call;
+    typedef function<void(PaymentStatus status, bool replayed)> Completion;
+
+private:
+    struct Job {
+        Call call;
+        Completion done;
+        chrono::steady_clock::time_point startAt;
+        chrono::steady_clock::time_point deadline;
+        atomic<bool> answered;
+        bool running;
+        bool abandoned;
+
+        Job(Call call, Completion done, chrono::steady_clock::time_point startAt, chrono::steady_clock::time_point deadline)
+            : call(move(call)), done(move(done)), startAt(startAt), deadline(deadline),
+              answered(false), running(false), abandoned(false) {}
+    };
+    typedef shared_ptr<Job> JobPtr;
+
+    struct LaterStart {
+        bool operator()(const JobPtr& a, const JobPtr& b) const { return a->startAt > b->startAt; }
+    };
+    struct LaterDeadline {
+        bool operator()(const JobPtr& a, const JobPtr& b) const { return a->deadline > b->deadline; }
+    };
+
+    size_t threadCount;
+    size_t activeWorkers;
+    size_t stuckWorkers;
+    unordered_map<thread::id, thread> workers;
+    vector<thread::id> exited;
+    thread timer;
+    deque<JobPtr> ready;
+    priority_queue<JobPtr, vector<JobPtr>, LaterStart> delayed;
+    priority_queue<JobPtr, vector<JobPtr>, LaterDeadline> watched;
+    mutex lock;
+    condition_variable hasWork;
+    condition_variable timerWake;
+    bool stopping;
+
+    // The worker and the timer race to answer a job; only the first counts.
+    static void answer(Job& job, PaymentStatus status, bool replayed) {
+        if (!job.answered.exchange(true, memory_order_acq_rel)) {
+            job.done(status, replayed);
+        }
+    }
+
+    void startWorker() {
+        activeWorkers++;
+        thread worker(&PaymentPipeline::runWorker, this);
+        thread::id id = worker.get_id();
+        workers.emplace(id, move(worker));
+    }
+
+    void runWorker();
+
+    // Releases delayed retries and times out calls past their deadline.
+    void runTimer();
+
+public:
+    explicit PaymentPipeline(size_t threadCount)
+        : threadCount(max(threadCount, static_cast<size_t>(1))), activeWorkers(0), stuckWorkers(0), stopping(false) {}
+
+    ~PaymentPipeline();
+
+    // Runs call at startAt and reports through done exactly once.
+    void schedule(Call call, Completion done, chrono::steady_clock::time_point startAt, chrono::milliseconds timeout);
+
+    size_t getWorkerCount() {
+        lock_guard<mutex> guard(lock);
+        return workers.size();
+    }
+};
+
+// ==================== PAYMENT REGISTRY ====================
+struct PaymentProviderStats {
+    int id;
+    const char* method;
+    unsigned long long payments;
+    unsigned long long failures;
+    unsigned long long retries;
+    long long totalMicros;
+    long long maxMicros;
+};
+
+// Preconstructed payment strategies and gateways keyed by method ID.
+class PaymentRegistry {
+private:
+    struct alignas(64) Provider {
+        int id;
+        const char* icon;
+        unique_ptr<PaymentStrategy> strategy;
+        shared_ptr<PaymentGateway> gateway;
+        PaymentPolicy policy;
+        atomic<unsigned long long> payments;
+        atomic<unsigned long long> failures;
+        atomic<unsigned long long> retries;
+        atomic<long long> totalMicros;
+        atomic<long long> maxMicros;
+
+        Provider(int id, const char* icon, unique_ptr<PaymentStrategy> strategy,
+                 shared_ptr<PaymentGateway> gateway, const PaymentPolicy& policy)
+            : id(id), icon(icon), strategy(move(strategy)), gateway(move(gateway)), policy(policy),
+              payments(0), failures(0), retries(0), totalMicros(0), maxMicros(0) {}
+    };
+
+    static const int MAX_PROVIDER_ID = 99;
+    static const size_t PIPELINE_THREADS = 16;
+
+    vector<unique_ptr<Provider>> providers;
+    vector<Provider*> byId;
+    PaymentPipeline pipeline;
+
+    static string idempotencyKey(int orderId) { return "order-" + to_string(orderId); }
+
+    Provider* lookup(int id) const {
+        if (id <= 0 || static_cast<size_t>(id) >= byId.size()) return nullptr;
+        return byId[id];
+    }
+
+    struct Authorization {
+        Provider* provider;
+        Money amount;
+        string key;
+        chrono::steady_clock::time_point started;
+        function<void()> notify;
+        PaymentResult result;
+        promise<PaymentResult> settled;
+    };
+
+    // Retries failures and timeouts under the same idempotency key.
+    void attempt(shared_ptr<Authorization> authorization, chrono::steady_clock::time_point startAt);
+
+    void record(Provider& provider, const PaymentResult& result, chrono::steady_clock::time_point started);
+
+public:
+    PaymentRegistry() : pipeline(PIPELINE_THREADS) {}
+
+    // Call before any session starts paying.
+    void registerProvider(int id, const char* icon, unique_ptr<PaymentStrategy> strategy,
+                          shared_ptr<PaymentGateway> gateway = nullptr, const PaymentPolicy& policy = PaymentPolicy());
+
+    bool contains(int id) const { return lookup(id) != nullptr; }
+
+    Result<const char*> lookupMethodName(int id) const;
+
+    const char* getMethodName(int id) const {
+        return lookupMethodName(id).valueOrThrow();
+    }
+
+    int getMaxId() const { return byId.empty() ? 0 : static_cast<int>(byId.size()) - 1; }
+
+    // Starts authorizing and returns at once; the order ID is the idempotency key.
+    future<PaymentResult> authorize(int id, Money amount, int orderId, function<void()> notify = nullptr);
+
+    PaymentStrategy& pay(int id, Money amount, int orderId, ostream* receipt) {
+        STORE_METRIC_SCOPE(METRIC_PAYMENT);
+        return settle(id, amount, authorize(id, amount, orderId).get(), receipt);
+    }
+
+    // Throws PaymentFailedException unless the provider approved.
+    PaymentStrategy& settle(int id, Money amount, const PaymentResult& result, ostream* receipt);
+
+    // Hands back an approved payment whose order could not be placed.
+    bool refund(int id, Money amount, int orderId);
+
+    void displayMenu() const {
+        for (const unique_ptr<Provider>& provider : providers) {
+            cout << "║  " << provider->id << ". " << provider->icon << ' '
+                 << left << setw(provider->id < 10 ? 35 : 34) << provider->strategy->getMethodName() << "║\n";
+        }
+    }
+
+    vector<PaymentProviderStats> getStats() const;
+};
+
+#endif
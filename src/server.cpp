@@ -0,0 +1,498 @@
+#include "server.h"
+#include "store.h"
+
+#ifdef __linux__
+#include <csignal>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#endif
+
+// ==================== NETWORK ====================
+// Loopback batch server and load generator (Linux only).
+const int MAX_REQUEST_BYTES = 65536;
+const size_t MAX_PENDING_OUTPUT = 1 << 20;
+const int MAX_EPOLL_EVENTS = 256;
+const int SERVER_POLL_MS = 200;
+
+#ifdef __linux__
+static volatile sig_atomic_t serverStopRequested = 0;
+
+static void requestServerStop(int) {
+    serverStopRequested = 1;
+}
+
+static void installServerSignals() {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = requestServerStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+}
+
+static void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw runtime_error("Failed to make socket non-blocking.");
+    }
+}
+
+static void setNoDelay(int fd) {
+    int enabled = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+}
+
+static sockaddr_in loopbackAddress(int port) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+static int openListener(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw runtime_error("Failed to create server socket.");
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = loopbackAddress(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        throw runtime_error("Failed to listen on the server port.");
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+static int connectLoopback(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw runtime_error("Failed to create client socket.");
+    }
+    sockaddr_in address = loopbackAddress(port);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        throw runtime_error("Failed to connect to the server.");
+    }
+    setNoDelay(fd);
+    setNonBlocking(fd);
+    return fd;
+}
+
+// One non-blocking connection with its unparsed input and unsent output.
+class LineConnection {
+private:
+    int fd;
+    int poller;
+    uint32_t interest;
+    string input;
+    size_t inputStart;
+    string output;
+    size_t outputSent;
+    bool paused;
+    bool peerClosed;
+
+public:
+    LineConnection(int fd, int poller)
+        : fd(fd), poller(poller), interest(EPOLLIN), inputStart(0), outputSent(0), paused(false), peerClosed(false) {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = interest;
+        event.data.fd = fd;
+        if (epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event) != 0) {
+            throw runtime_error("Failed to watch connection.");
+        }
+    }
+
+    LineConnection(const LineConnection&) = delete;
+    LineConnection& operator=(const LineConnection&) = delete;
+
+    ~LineConnection() {
+        epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+    }
+
+    int getFd() const { return fd; }
+    string& getOutput() { return output; }
+    size_t getPendingOutput() const { return output.size() - outputSent; }
+    bool isPaused() const { return paused; }
+    void setPaused(bool pause) { paused = pause; }
+    bool isPeerClosed() const { return peerClosed; }
+    void markPeerClosed() { peerClosed = true; }
+
+    void watch(uint32_t events) {
+        if (events == interest) return;
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(poller, EPOLL_CTL_MOD, fd, &event) != 0) {
+            throw runtime_error("Failed to watch connection.");
+        }
+        interest = events;
+    }
+
+    bool receive() {
+        char chunk[16384];
+        for (;;) {
+            ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+            if (received > 0) {
+                input.append(chunk, static_cast<size_t>(received));
+                if (static_cast<size_t>(received) < sizeof(chunk)) return true;
+            } else if (received == 0) {
+                return false;
+            } else {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+        }
+    }
+
+    bool nextLine(string_view& line) {
+        size_t end = input.find('\n', inputStart);
+        if (end == string::npos) {
+            input.erase(0, inputStart);
+            inputStart = 0;
+            return false;
+        }
+        line = string_view(input).substr(inputStart, end - inputStart);
+        inputStart = end + 1;
+        return true;
+    }
+
+    void unreadLine(string_view line) {
+        inputStart = static_cast<size_t>(line.data() - input.data());
+    }
+
+    bool isOverlong() const {
+        size_t lastEnd = input.rfind('\n');
+        size_t lineStart = lastEnd == string::npos ? inputStart : max(lastEnd + 1, inputStart);
+        return input.size() - lineStart > static_cast<size_t>(MAX_REQUEST_BYTES);
+    }
+
+    bool flush() {
+        while (outputSent < output.size()) {
+            ssize_t sent = send(fd, output.data() + outputSent, output.size() - outputSent, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            outputSent += static_cast<size_t>(sent);
+        }
+        if (outputSent == output.size()) {
+            output.clear();
+            outputSent = 0;
+        }
+        uint32_t events = 0;
+        if (getPendingOutput() > 0) events |= EPOLLOUT;
+        if (getPendingOutput() < MAX_PENDING_OUTPUT && !paused && !peerClosed) events |= EPOLLIN;
+        watch(events);
+        return true;
+    }
+};
+#endif
+
+void ECommerceSystem::runServer(int port) {
+#ifdef __linux__
+    OrderLogger::getInstance();
+    installServerSignals();
+
+    int listener = openListener(port);
+    int poller = epoll_create1(EPOLL_CLOEXEC);
+    if (poller < 0) {
+        close(listener);
+        throw runtime_error("Failed to create epoll instance.");
+    }
+    // The last authorization holding the eventfd closes it.
+    shared_ptr<int> wakeup(new int(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), [](int* fd) {
+        if (*fd >= 0) close(*fd);
+        delete fd;
+    });
+    if (*wakeup < 0) {
+        close(poller);
+        close(listener);
+        throw runtime_error("Failed to create eventfd.");
+    }
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event);
+    event.data.fd = *wakeup;
+    epoll_ctl(poller, EPOLL_CTL_ADD, *wakeup, &event);
+    cerr << "Serving on 127.0.0.1:" << port << "\n";
+
+    unordered_map<string, ShoppingCart> sessions;
+    sessions.swap(restoredCarts);
+    unordered_map<int, unique_ptr<LineConnection>> connections;
+    CheckoutQueue checkouts;
+    checkouts.notify = [wakeup]() {
+        uint64_t one = 1;
+        ssize_t written = write(*wakeup, &one, sizeof(one));
+        (void)written;
+    };
+    vector<int> waitingForSession;
+    BatchRequest request;
+    ostringstream results;
+    unsigned long long processed = 0;
+    unsigned long long lastSweep = 0;
+    epoll_event events[MAX_EPOLL_EVENTS];
+
+    // Handles buffered lines until the connection has to wait for a payment.
+    auto serve = [&](int fd) {
+        unordered_map<int, unique_ptr<LineConnection>>::iterator found = connections.find(fd);
+        if (found == connections.end()) return;
+        LineConnection& connection = *found->second;
+
+        string_view line;
+        while (!connection.isPaused() && connection.getPendingOutput() < MAX_PENDING_OUTPUT && connection.nextLine(line)) {
+            if (line.find_first_not_of(" \t\r") == string_view::npos) continue;
+            if (!request.parse(line)) {
+                writeError(results, "", "", "Malformed request");
+            } else {
+                if (isSessionOp(request.getString("op"))) {
+                    unordered_map<string, ShoppingCart>::iterator cart = sessions.find(string(request.getString("session")));
+                    if (cart != sessions.end() && cart->second.isPaymentPending()) {
+                        connection.unreadLine(line);
+                        connection.setPaused(true);
+                        waitingForSession.push_back(fd);
+                        break;
+                    }
+                }
+                size_t inFlight = checkouts.pending.size();
+                processBatchRequest(request, sessions, checkouts, results);
+                processed++;
+                if (checkouts.pending.size() > inFlight) {
+                    checkouts.pending.back().owner = fd;
+                    connection.setPaused(true);
+                }
+            }
+            connection.getOutput() += results.str();
+            results.str("");
+        }
+        if (!connection.flush() || connection.isOverlong() || (connection.isPeerClosed() && !connection.isPaused())) {
+            for (PendingCheckout& checkout : checkouts.pending) {
+                if (checkout.owner == fd) checkout.owner = -1;
+            }
+            connections.erase(found);
+        }
+    };
+
+    // Finishes settled checkouts and resumes the connections waiting on them.
+    auto settleReady = [&]() {
+        for (;;) {
+            vector<int> resumed;
+            for (deque<PendingCheckout>::iterator it = checkouts.pending.begin(); it != checkouts.pending.end();) {
+                if (it->payment.wait_for(chrono::seconds(0)) != future_status::ready) {
+                    ++it;
+                    continue;
+                }
+                PendingCheckout checkout = move(*it);
+                it = checkouts.pending.erase(it);
+                finishBatchCheckout(checkout, results);
+                unordered_map<int, unique_ptr<LineConnection>>::iterator owner = connections.find(checkout.owner);
+                if (owner != connections.end()) {
+                    owner->second->getOutput() += results.str();
+                    owner->second->setPaused(false);
+                    resumed.push_back(checkout.owner);
+                }
+                results.str("");
+            }
+            if (resumed.empty()) return;
+
+            for (int fd : waitingForSession) {
+                unordered_map<int, unique_ptr<LineConnection>>::iterator waiting = connections.find(fd);
+                if (waiting != connections.end()) {
+                    waiting->second->setPaused(false);
+                    resumed.push_back(fd);
+                }
+            }
+            waitingForSession.clear();
+            for (int fd : resumed) {
+                serve(fd);
+            }
+        }
+    };
+
+    while (!serverStopRequested) {
+        int ready = epoll_wait(poller, events, MAX_EPOLL_EVENTS, SERVER_POLL_MS);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.fd == listener) {
+                int client;
+                while ((client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    setNoDelay(client);
+                    connections[client].reset(new LineConnection(client, poller));
+                }
+                continue;
+            }
+            if (events[i].data.fd == *wakeup) {
+                uint64_t count;
+                ssize_t drained = read(*wakeup, &count, sizeof(count));
+                (void)drained;
+                continue;
+            }
+
+            unordered_map<int, unique_ptr<LineConnection>>::iterator found = connections.find(events[i].data.fd);
+            if (found == connections.end()) continue;
+            LineConnection& connection = *found->second;
+
+            if (events[i].events & EPOLLERR) {
+                connection.markPeerClosed();
+            } else if ((events[i].events & (EPOLLIN | EPOLLHUP)) && !connection.isPeerClosed() && !connection.receive()) {
+                connection.markPeerClosed();
+            }
+            serve(events[i].data.fd);
+        }
+        settleReady();
+
+        if (processed - lastSweep >= static_cast<unsigned long long>(EXPIRY_SWEEP_REQUESTS) ||
+            (ready == 0 && processed != lastSweep)) {
+            runHousekeeping(sessions, cerr);
+            lastSweep = processed;
+        }
+    }
+
+    settleCheckouts(checkouts, results);
+    connections.clear();
+    close(poller);
+    close(listener);
+    saveChangedCarts(sessions);
+    cerr << "Server stopped after " << processed << " requests\n";
+#else
+    (void)port;
+    throw runtime_error("The network front end needs Linux.");
+#endif
+}
+
+// ==================== LOAD GENERATOR ====================
+static void buildLoadRequest(const LoadGenConfig& config, int connection, long long sequence, string& out) {
+    const string& code = config.codes[static_cast<size_t>(sequence / 2 + connection) % config.codes.size()];
+    string session = "\"session\":\"lg" + to_string(connection) + "\"";
+    switch (sequence % 8) {
+        case 0:
+        case 2:
+        case 7:
+            out = "{\"op\":\"product\"," + session + ",\"code\":\"" + code + "\"}\n";
+            break;
+        case 1:
+        case 3:
+            out = "{\"op\":\"add\"," + session + ",\"code\":\"" + code + "\",\"qty\":1}\n";
+            break;
+        case 4:
+            out = "{\"op\":\"quote\"," + session + ",\"payment\":1}\n";
+            break;
+        case 5:
+            out = "{\"op\":\"checkout\"," + session + ",\"payment\":1}\n";
+            break;
+        default: {
+            long long now = Order::currentTime();
+            out = "{\"op\":\"list_orders\"," + session + ",\"from\":" + to_string(now - 1) +
+                  ",\"to\":" + to_string(now + 1) + "}\n";
+            break;
+        }
+    }
+}
+
+void runLoadGenerator(const LoadGenConfig& config, ostream& out) {
+#ifdef __linux__
+    struct Client {
+        unique_ptr<LineConnection> connection;
+        long long sent;
+        chrono::steady_clock::time_point sentAt;
+    };
+
+    if (config.codes.empty()) {
+        throw invalid_argument("The load generator needs at least one product code.");
+    }
+    signal(SIGPIPE, SIG_IGN);
+    int poller = epoll_create1(EPOLL_CLOEXEC);
+    if (poller < 0) {
+        throw runtime_error("Failed to create epoll instance.");
+    }
+
+    long long requested = 0;
+    long long completed = 0;
+    long long errors = 0;
+    vector<double> latencies;
+    latencies.reserve(static_cast<size_t>(config.requests));
+    string request;
+    vector<Client> clients(static_cast<size_t>(max(config.connections, 1)));
+    unordered_map<int, size_t> clientByFd;
+
+    auto sendNext = [&](size_t index) {
+        Client& client = clients[index];
+        if (requested >= config.requests) return;
+        buildLoadRequest(config, static_cast<int>(index), client.sent++, request);
+        requested++;
+        client.connection->getOutput() += request;
+        client.sentAt = chrono::steady_clock::now();
+        if (!client.connection->flush()) {
+            throw runtime_error("Lost connection to the server.");
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < clients.size(); i++) {
+        int fd = connectLoopback(config.port);
+        clients[i].connection.reset(new LineConnection(fd, poller));
+        clients[i].sent = 0;
+        clientByFd[fd] = i;
+        sendNext(i);
+    }
+
+    epoll_event events[MAX_EPOLL_EVENTS];
+    while (completed < requested) {
+        int ready = epoll_wait(poller, events, MAX_EPOLL_EVENTS, 5000);
+        if (ready == 0) {
+            throw runtime_error("The server stopped responding.");
+        }
+        for (int i = 0; i < ready; i++) {
+            size_t index = clientByFd[events[i].data.fd];
+            LineConnection& connection = *clients[index].connection;
+            bool open = connection.receive();
+            string_view line;
+            while (connection.nextLine(line)) {
+                auto now = chrono::steady_clock::now();
+                latencies.push_back(chrono::duration<double, micro>(now - clients[index].sentAt).count());
+                if (line.find("\"ok\":true") == string_view::npos) errors++;
+                completed++;
+                sendNext(index);
+            }
+            if (!open || !connection.flush()) {
+                throw runtime_error("Lost connection to the server.");
+            }
+        }
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t connectionCount = clients.size();
+    clients.clear();
+    close(poller);
+
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies.empty() ? 0.0 : latencies[min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    out << "Requests:    " << completed << " over " << connectionCount << " connections, " << errors << " errors\n"
+        << fixed << setprecision(0)
+        << "Throughput:  " << (elapsed > 0.0 ? static_cast<double>(completed) / elapsed : 0.0) << " requests/s\n"
+        << setprecision(1)
+        << "Latency us:  p50 " << percentile(0.50) << "  p99 " << percentile(0.99)
+        << "  max " << (latencies.empty() ? 0.0 : latencies.back()) << "\n";
+#else
+    (void)config;
+    (void)out;
+    throw runtime_error("The load generator needs Linux.");
+#endif
+}
@@ -0,0 +1,20 @@
+#ifndef STORE_SERVER_H
+#define STORE_SERVER_H
+
+#include "common.h"
+
+// ==================== LOAD GENERATOR ====================
+struct LoadGenConfig {
+    int port;
+    int connections;
+    long long requests;
+    vector<string> codes;
+
+    LoadGenConfig() : port(0), connections(16), requests(100000),
+                      codes({"LAP", "PHN", "HDP", "KEY", "MOU"}) {}
+};
+
+// Closed-loop load against a running --serve instance.
+void runLoadGenerator(const LoadGenConfig& config, ostream& out);
+
+#endif
@@ -0,0 +1,1121 @@
+#include "store.h"
+
+// ==================== ECOMMERCE SYSTEM ====================
+void ECommerceSystem::displayMainMenu() {
+    cout << "\n╔════════════════════════════════════════════╗\n";
+    cout << "║          🛒 E-COMMERCE SYSTEM MENU         ║\n";
+    cout << "╠════════════════════════════════════════════╣\n";
+    cout << "║  1. 🏷️  View Products                      ║\n";
+    cout << "║  2. 🛍️  View Shopping Cart                 ║\n";
+    cout << "║  3. 📋 View Orders                         ║\n";
+    cout << "║  4. 🚪 Exit                                ║\n";
+    cout << "╚════════════════════════════════════════════╝\n";
+}
+
+void ECommerceSystem::displaySearchResults(string_view query) {
+    vector<SearchHit> hits = engine.searchProducts(query, SEARCH_RESULT_LIMIT);
+    CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+
+    screen.add("╔══════════╦══════════════════════╦════════════╗\n"
+               "║   ID     ║        Name          ║   Price    ║\n"
+               "╠══════════╬══════════════════════╬════════════╣\n");
+    int shown = 0;
+    for (const SearchHit& hit : hits) {
+        int slot = catalog->getIndex().find(ProductIndex::packCode(hit.code));
+        if (slot >= 0) {
+            catalog->getProducts()[slot].display(screen);
+            shown++;
+        }
+    }
+    if (shown == 0) {
+        screen.add("║             No matching products             ║\n");
+    }
+    screen.add("╚══════════╩══════════════════════╩════════════╝\n");
+    screen.flush(cout);
+}
+
+void ECommerceSystem::handleViewProducts() {
+    char choice = 'Y';
+    do {
+        try {
+            engine.getCatalog().read()->displayProducts(screen);
+
+            auto readProductCode = [this]() {
+                return getProductCodeInput(
+                    "\n╔════════════════════════════════════════════╗\n"
+                    "║ Enter Product Code to add to cart (0 to back)║\n"
+                    "║ or ?name to search, e.g. ?blue speaker     ║\n"
+                    "╚════════════════════════════════════════════╝\n"
+                    "➡ Product Code: ",
+                    [this](string_view code) { return engine.getCatalog().read()->getIndex().contains(code); }
+                );
+            };
+            string productCode = readProductCode();
+            while (productCode[0] == '?') {
+                displaySearchResults(string_view(productCode).substr(1));
+                productCode = readProductCode();
+            }
+            
+            if (productCode == "0") return;
+
+            Product product = engine.getCatalog().read()->findProductById(productCode);
+            
+            int quantity = getValidInput(
+                "╔════════════════════════════════════════════╗\n"
+                "║        Enter quantity:                     ║\n"
+                "╚════════════════════════════════════════════╝\n"
+                "➡ Quantity: ",
+                1
+            );
+
+            cart.addProduct(product, quantity);
+            
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║          ✔ Product added to cart!          ║\n";
+            cout << "║         Quantity: " << left << setw(22) << quantity << "║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+        } catch (const exception& e) {
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║               ❗ ERROR:                     ║\n";
+            cout << "║ " << left << setw(40) << e.what() << " ║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+        }
+
+        choice = getYesNoInput("➡ Add another product? (Y/N): ");
+    } while (choice == 'Y');
+}
+
+void ECommerceSystem::handleViewCart() {
+    try {
+        cart.display(screen, *engine.getCatalog().read());
+        
+        char choice = getYesNoInput(
+            "╔════════════════════════════════════════════╗\n"
+            "║        Proceed to checkout? (Y/N)          ║\n"
+            "╚════════════════════════════════════════════╝\n"
+            "➡ Choice: "
+        );
+        
+        if (choice == 'Y') {
+            checkout();
+            engine.compactIfDue();
+        }
+    } catch (const EmptyCartException& e) {
+        cout << "╔════════════════════════════════════════════╗\n";
+        cout << "║              🛒 CART EMPTY                 ║\n";
+        cout << "║ " << left << setw(40) << "Add products before checking out!" << " ║\n";
+        cout << "╚════════════════════════════════════════════╝\n";
+    } catch (const PaymentFailedException& e) {
+        cout << "╔════════════════════════════════════════════╗\n";
+        cout << "║            ❌ PAYMENT FAILED               ║\n";
+        cout << "║ " << left << setw(40) << e.what() << " ║\n";
+        cout << "╚════════════════════════════════════════════╝\n";
+    } catch (const exception& e) {
+        cout << "╔════════════════════════════════════════════╗\n";
+        cout << "║               ❗ ERROR:                     ║\n";
+        cout << "║ " << left << setw(40) << e.what() << " ║\n";
+        cout << "╚════════════════════════════════════════════╝\n";
+    }
+}
+
+void ECommerceSystem::checkout() {
+    cout << "\n╔════════════════════════════════════════════╗\n";
+    cout << "║           🏁 CHECKOUT SUMMARY             ║\n";
+    cout << "╚════════════════════════════════════════════╝\n";
+    cart.display(screen, *engine.getCatalog().read());
+
+    PaymentRegistry& payments = engine.getPayments();
+    cout << "╔════════════════════════════════════════════╗\n";
+    cout << "║           💳 SELECT PAYMENT METHOD        ║\n";
+    cout << "╠════════════════════════════════════════════╣\n";
+    payments.displayMenu();
+    cout << "╚════════════════════════════════════════════╝\n";
+
+    int paymentChoice = getValidInput("➡ Your choice: ", 1, payments.getMaxId());
+    while (!payments.contains(paymentChoice)) {
+        cout << "╔════════════════════════════════════════════╗\n";
+        cout << "║          ❗ INVALID INPUT                  ║\n";
+        cout << "║ Please choose a listed payment method.     ║\n";
+        cout << "╚════════════════════════════════════════════╝\n";
+        paymentChoice = getValidInput("➡ Your choice: ", 1, payments.getMaxId());
+    }
+
+    STORE_METRIC_SCOPE(METRIC_CHECKOUT);
+    if (cart.getCheckoutOrderId() == 0) {
+        cart.setCheckoutOrderId(engine.reserveOrderId());
+    }
+    int orderId = cart.getCheckoutOrderId();
+    CartPricing pricing = engine.priceCart(cart, payments.getMethodName(paymentChoice));
+    if (pricing.discount.getCents() != 0) {
+        screen.add("╔════════════════════════════════════════════╗\n"
+                   "║           🎁 PROMOTIONS APPLIED            ║\n"
+                   "╠════════════════════════════════════════════╣\n");
+        screen.add("║  Subtotal: PHP ").left(pricing.subtotal, 29).add("║\n");
+        screen.add("║  Discount: PHP ").left(pricing.discount, 29).add("║\n");
+        screen.add("║  To pay: PHP ").left(pricing.getTotal(), 31).add("║\n");
+        screen.add("╚════════════════════════════════════════════╝\n");
+        screen.flush(cout);
+    }
+    PaymentStrategy& paymentStrategy = payments.pay(paymentChoice, pricing.getTotal(), orderId, &cout);
+
+    ReadSection reading;
+    const Order* placed = nullptr;
+    try {
+        placed = &engine.placeOrder(orderId, cart, &paymentStrategy, pricing);
+    } catch (const exception&) {
+        bool refunded = payments.refund(paymentChoice, pricing.getTotal(), orderId);
+        cout << "╔════════════════════════════════════════════╗\n";
+        cout << "║            ❌ ORDER NOT SAVED              ║\n";
+        cout << "║ " << left << setw(40) << (refunded ? "Your payment has been refunded." : "Refund failed. Please contact us.")
+             << " ║\n";
+        cout << "╚════════════════════════════════════════════╝\n";
+        throw;
+    }
+    const Order& order = *placed;
+
+    cout << "╔════════════════════════════════════════════╗\n";
+    cout << "║          [LOG] -> Order ID: " << left << setw(16) << order.getOrderId() << "║\n";
+    cout << "║   has been successfully checked out        ║\n";
+    cout << "║   and paid using " << left << setw(25) << order.getPaymentMethod() << "║\n";
+    cout << "╚════════════════════════════════════════════╝\n";
+
+    cout << "╔════════════════════════════════════════════╗\n";
+    cout << "║          🎉 ORDER COMPLETED!              ║\n";
+    cout << "╚════════════════════════════════════════════╝\n";
+
+    cart.commitStock();
+    cart.clear();
+}
+
+void ECommerceSystem::handleViewOrders() {
+    ReadSection reading;
+    vector<const Order*> orders = engine.getOrders().collect();
+    if (orders.empty()) {
+        cout << "╔════════════════════════════════════════════╗\n";
+        cout << "║           📭 NO ORDERS YET               ║\n";
+        cout << "╚════════════════════════════════════════════╝\n";
+        return;
+    }
+
+    cout << "\n╔════════════════════════════════════════════╗\n";
+    cout << "║              ORDER HISTORY                ║\n";
+    cout << "╚════════════════════════════════════════════╝\n";
+
+    CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+    bool finished = renderPaged(screen, orders.size(), ORDERS_PER_PAGE,
+        [](RenderBuffer&) {},
+        [&](RenderBuffer& page, size_t i) { orders[i]->display(page, *catalog); },
+        [](RenderBuffer& page, bool last) {
+            if (last) {
+                page.add("╔════════════════════════════════════════════╗\n"
+                         "║           END OF ORDER HISTORY            ║\n"
+                         "╚════════════════════════════════════════════╝\n");
+            }
+        });
+
+    if (finished) {
+        displaySalesSummary(*catalog);
+    }
+}
+
+void ECommerceSystem::displaySalesSummary(const ProductCatalog& catalog) {
+    const SalesAnalytics& analytics = engine.getAnalytics();
+
+    cout << "\n╔════════════════════════════════════════════╗\n";
+    cout << "║              📈 SALES SUMMARY              ║\n";
+    cout << "╠════════════════════════════════════════════╣\n";
+    cout << "║  Top products by list-price revenue:       ║\n";
+    for (const ProductSales& sales : analytics.topProducts(3)) {
+        int slot = catalog.getIndex().find(ProductIndex::packCode(sales.code));
+        const char* name = slot >= 0 ? catalog.getProducts()[slot].getName() : sales.code;
+        cout << "║    " << left << setw(20) << name << right << setw(19) << sales.grossRevenue << " ║\n";
+    }
+    cout << "╠════════════════════════════════════════════╣\n";
+    cout << "║  Net revenue by payment method:            ║\n";
+    for (const MethodSales& sales : analytics.revenueByMethod()) {
+        cout << "║    " << left << setw(20) << sales.method << right << setw(19) << sales.netRevenue << " ║\n";
+    }
+    cout << "╚════════════════════════════════════════════╝\n";
+}
+
+void ECommerceSystem::beginResult(ostream& out, string_view op, string_view session, bool ok) {
+    out << "{\"op\":";
+    writeJsonString(out, op);
+    if (!session.empty()) {
+        out << ",\"session\":";
+        writeJsonString(out, session);
+    }
+    out << ",\"ok\":" << (ok ? "true" : "false");
+}
+
+void ECommerceSystem::handleBatchAdd(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out) {
+    string code(request.getString("code"));
+    for (char &c : code) {
+        c = toupper(c);
+    }
+
+    long long quantity = 1;
+    if (request.has("qty") && !request.getInt("qty", quantity)) {
+        writeError(out, "add", session, "Quantity must be a number");
+        return;
+    }
+    if (quantity <= 0 || quantity > INT_MAX) {
+        writeError(out, "add", session, "Quantity must be positive");
+        return;
+    }
+
+    {
+        CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+        Result<const Product*> product = catalog->lookupProduct(code);
+        if (!product) {
+            writeError(out, "add", session, storeErrorMessage(product.getError()));
+            return;
+        }
+        sessionCart.addProduct(*product.getValue(), static_cast<int>(quantity));
+    }
+
+    beginResult(out, "add", session, true);
+    out << ",\"code\":";
+    writeJsonString(out, code);
+    out << ",\"qty\":" << quantity
+        << ",\"lines\":" << sessionCart.getItemCount()
+        << ",\"total\":" << sessionCart.calculateTotal() << "}\n";
+}
+
+void ECommerceSystem::handleBatchAddMany(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out) {
+    vector<string> codes;
+    vector<string> quantityFields;
+    splitCsvLine(request.getString("codes"), codes);
+    if (request.has("qtys")) {
+        splitCsvLine(request.getString("qtys"), quantityFields);
+        if (quantityFields.size() != codes.size()) {
+            writeError(out, "add_many", session, "codes and qtys must have the same length");
+            return;
+        }
+    }
+
+    vector<const char*> codePointers(codes.size());
+    vector<int> quantities(codes.size(), 1);
+    for (size_t i = 0; i < codes.size(); i++) {
+        for (char &c : codes[i]) {
+            c = toupper(c);
+        }
+        codePointers[i] = codes[i].c_str();
+        if (!quantityFields.empty()) {
+            long long quantity = 0;
+            if (parseNumber(string_view(quantityFields[i]), quantity) != ParseStatus::Ok || quantity <= 0 || quantity > INT_MAX) {
+                writeError(out, "add_many", session, "Quantity must be positive");
+                return;
+            }
+            quantities[i] = static_cast<int>(quantity);
+        }
+    }
+
+    StoreError error;
+    {
+        CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+        error = sessionCart.tryAddProducts(*catalog, codePointers.data(), quantities.data(), codes.size());
+    }
+    if (error != StoreError::None) {
+        writeError(out, "add_many", session, storeErrorMessage(error));
+        return;
+    }
+
+    beginResult(out, "add_many", session, true);
+    out << ",\"added\":" << codes.size()
+        << ",\"lines\":" << sessionCart.getItemCount()
+        << ",\"total\":" << sessionCart.calculateTotal() << "}\n";
+}
+
+void ECommerceSystem::handleBatchReorder(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out) {
+    long long orderId = 0;
+    const Order* order = nullptr;
+    ReadSection reading;
+    if (request.getInt("order_id", orderId) && orderId > 0 && orderId <= INT_MAX) {
+        order = engine.getOrders().find(static_cast<int>(orderId));
+    }
+    if (order == nullptr) {
+        writeError(out, "reorder", session, "Order not found");
+        return;
+    }
+
+    vector<const char*> codes(order->getLineCount());
+    vector<int> quantities(order->getLineCount());
+    for (int i = 0; i < order->getLineCount(); i++) {
+        codes[i] = order->getLines()[i].code;
+        quantities[i] = order->getLines()[i].quantity;
+    }
+
+    StoreError error;
+    {
+        CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+        error = sessionCart.tryAddProducts(*catalog, codes.data(), quantities.data(), codes.size());
+    }
+    if (error != StoreError::None) {
+        writeError(out, "reorder", session, storeErrorMessage(error));
+        return;
+    }
+
+    beginResult(out, "reorder", session, true);
+    out << ",\"order_id\":" << orderId
+        << ",\"lines\":" << sessionCart.getItemCount()
+        << ",\"total\":" << sessionCart.calculateTotal() << "}\n";
+}
+
+void ECommerceSystem::handleBatchCheckout(const BatchRequest& request, const string& session, ShoppingCart& sessionCart,
+                                          CheckoutQueue& checkouts, ostream& out) {
+    if (sessionCart.getItemCount() == 0) {
+        writeError(out, "checkout", session, storeErrorMessage(StoreError::EmptyCart));
+        return;
+    }
+
+    long long paymentChoice = 0;
+    Result<const char*> methodName = lookupPaymentMethod(request, paymentChoice);
+    if (!methodName) {
+        writeError(out, "checkout", session, storeErrorMessage(methodName.getError()));
+        return;
+    }
+
+    if (sessionCart.getCheckoutOrderId() == 0) {
+        sessionCart.setCheckoutOrderId(engine.reserveOrderId());
+    }
+    int orderId = sessionCart.getCheckoutOrderId();
+    int method = static_cast<int>(paymentChoice);
+    CartPricing pricing = engine.priceCart(sessionCart, methodName.getValue());
+    future<PaymentResult> payment = engine.getPayments().authorize(method, pricing.getTotal(), orderId, checkouts.notify);
+
+    sessionCart.setPaymentPending(true);
+    checkouts.pending.push_back(PendingCheckout{session, &sessionCart, orderId, method, pricing, move(payment)});
+}
+
+void ECommerceSystem::finishBatchCheckout(PendingCheckout& checkout, ostream& out) {
+    STORE_METRIC_SCOPE(METRIC_CHECKOUT);
+    ShoppingCart& sessionCart = *checkout.cart;
+    sessionCart.setPaymentPending(false);
+    try {
+        PaymentStrategy& paymentStrategy =
+            engine.getPayments().settle(checkout.method, checkout.pricing.getTotal(), checkout.payment.get(), nullptr);
+
+        ReadSection reading;
+        const Order* placed = nullptr;
+        try {
+            placed = &engine.placeOrder(checkout.orderId, sessionCart, &paymentStrategy, checkout.pricing);
+        } catch (const exception& e) {
+            bool refunded = engine.getPayments().refund(checkout.method, checkout.pricing.getTotal(), checkout.orderId);
+            beginResult(out, "checkout", checkout.session, false);
+            out << ",\"error\":";
+            writeJsonString(out, e.what());
+            out << ",\"refunded\":" << (refunded ? "true" : "false") << "}\n";
+            return;
+        }
+        const Order& order = *placed;
+        sessionCart.commitStock();
+        sessionCart.clear();
+
+        beginResult(out, "checkout", checkout.session, true);
+        out << ",\"order_id\":" << order.getOrderId()
+            << ",\"total\":" << order.getTotalAmount()
+            << ",\"payment\":";
+        writeJsonString(out, order.getPaymentMethod());
+        writePricing(out, checkout.pricing);
+        out << "}\n";
+    } catch (const exception& e) {
+        writeError(out, "checkout", checkout.session, e.what());
+    }
+}
+
+void ECommerceSystem::settleCheckouts(CheckoutQueue& checkouts, ostream& out, const ShoppingCart* cart) {
+    deque<PendingCheckout>& pending = checkouts.pending;
+    for (deque<PendingCheckout>::iterator it = pending.begin(); it != pending.end();) {
+        if (cart != nullptr && it->cart != cart) {
+            ++it;
+            continue;
+        }
+        PendingCheckout checkout = move(*it);
+        it = pending.erase(it);
+        finishBatchCheckout(checkout, out);
+        if (cart != nullptr) return;
+    }
+}
+
+void ECommerceSystem::settleReadyCheckouts(CheckoutQueue& checkouts, ostream& out) {
+    deque<PendingCheckout>& pending = checkouts.pending;
+    while (!pending.empty() &&
+           (pending.size() > MAX_INFLIGHT_CHECKOUTS ||
+            pending.front().payment.wait_for(chrono::seconds(0)) == future_status::ready)) {
+        PendingCheckout checkout = move(pending.front());
+        pending.pop_front();
+        finishBatchCheckout(checkout, out);
+    }
+}
+
+void ECommerceSystem::runBatchRequest(const BatchRequest& request, unordered_map<string, ShoppingCart>& sessions,
+                                      CheckoutQueue& checkouts, ostream& out) {
+    if (!checkouts.pending.empty()) {
+        if (!isSessionOp(request.getString("op"))) {
+            settleCheckouts(checkouts, out);
+        } else {
+            unordered_map<string, ShoppingCart>::iterator found = sessions.find(string(request.getString("session")));
+            if (found != sessions.end() && found->second.isPaymentPending()) {
+                settleCheckouts(checkouts, out, &found->second);
+            }
+        }
+    }
+    processBatchRequest(request, sessions, checkouts, out);
+    settleReadyCheckouts(checkouts, out);
+}
+
+void ECommerceSystem::writePricing(ostream& out, const CartPricing& pricing) {
+    out << ",\"subtotal\":" << pricing.subtotal << ",\"discount\":" << pricing.discount << ",\"promotions\":[";
+    for (int i = 0; i < pricing.promotionCount; i++) {
+        out << (i > 0 ? "," : "") << pricing.promotionIds[i];
+    }
+    out << ']';
+}
+
+void ECommerceSystem::handleBatchQuote(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out) {
+    long long paymentChoice = 0;
+    Result<const char*> methodName = lookupPaymentMethod(request, paymentChoice);
+    if (!methodName) {
+        writeError(out, "quote", session, storeErrorMessage(methodName.getError()));
+        return;
+    }
+    CartPricing pricing = engine.priceCart(sessionCart, methodName.getValue());
+    beginResult(out, "quote", session, true);
+    out << ",\"total\":" << pricing.getTotal();
+    writePricing(out, pricing);
+    out << "}\n";
+}
+
+void ECommerceSystem::handleBatchAddPromotion(const BatchRequest& request, const string& session, ostream& out) {
+    Promotion promotion;
+    string_view type = request.getString("type");
+    if (type == "percent") {
+        promotion.type = PromotionType::PercentOff;
+    } else if (type == "tier") {
+        promotion.type = PromotionType::VolumeTier;
+    } else if (type == "bundle") {
+        promotion.type = PromotionType::Bundle;
+    } else if (type == "method") {
+        promotion.type = PromotionType::PaymentMethod;
+    } else {
+        writeError(out, "add_promo", session, "type must be percent, tier, bundle or method");
+        return;
+    }
+
+    Money rate;
+    if (request.has("percent")) {
+        if (!Money::parse(request.getString("percent"), rate) || rate.getCents() > 10000) {
+            writeError(out, "add_promo", session, "percent must be a decimal between 0 and 100");
+            return;
+        }
+        promotion.basisPoints = static_cast<int>(rate.getCents());
+    }
+    if (request.has("amount") && !Money::parse(request.getString("amount"), promotion.amount)) {
+        writeError(out, "add_promo", session, "amount must be a decimal amount");
+        return;
+    }
+    long long minQuantity = 1;
+    if (request.has("min_qty") && (!request.getInt("min_qty", minQuantity) || minQuantity > INT_MAX)) {
+        writeError(out, "add_promo", session, "min_qty must be a number");
+        return;
+    }
+    promotion.minQuantity = static_cast<int>(minQuantity);
+    promotion.method = string(request.getString("method"));
+
+    string_view codes = request.has("codes") ? request.getString("codes") : request.getString("code");
+    while (!codes.empty()) {
+        size_t comma = codes.find(',');
+        string code(trimView(codes.substr(0, comma)));
+        for (char &c : code) {
+            c = toupper(c);
+        }
+        promotion.codes.push_back(code);
+        codes = comma == string_view::npos ? string_view() : codes.substr(comma + 1);
+    }
+
+    int id = engine.getPromotions().add(promotion);
+    beginResult(out, "add_promo", session, true);
+    out << ",\"id\":" << id << "}\n";
+}
+
+void ECommerceSystem::handleBatchListPromotions(const string& session, ostream& out) {
+    vector<Promotion> promotions = engine.getPromotions().list();
+    beginResult(out, "list_promos", session, true);
+    out << ",\"promotions\":[";
+    for (size_t i = 0; i < promotions.size(); i++) {
+        const Promotion& promotion = promotions[i];
+        string codes;
+        for (const string& code : promotion.codes) {
+            codes += (codes.empty() ? "" : ",") + code;
+        }
+        out << (i > 0 ? "," : "") << "{\"id\":" << promotion.id << ",\"type\":";
+        writeJsonString(out, promotionTypeName(promotion.type));
+        if (!codes.empty()) {
+            out << ",\"codes\":";
+            writeJsonString(out, codes);
+        }
+        if (promotion.type == PromotionType::VolumeTier) {
+            out << ",\"min_qty\":" << promotion.minQuantity;
+        }
+        if (promotion.type == PromotionType::Bundle) {
+            out << ",\"amount\":" << promotion.amount;
+        } else {
+            out << ",\"percent\":" << Money::fromCents(promotion.basisPoints);
+        }
+        if (promotion.type == PromotionType::PaymentMethod) {
+            out << ",\"method\":";
+            writeJsonString(out, promotion.method);
+        }
+        out << '}';
+    }
+    out << "]}\n";
+}
+
+void ECommerceSystem::handleBatchCatalogUpdate(string_view op, const BatchRequest& request, const string& session, ostream& out) {
+    string code(request.getString("code"));
+    for (char &c : code) {
+        c = toupper(c);
+    }
+    string name(request.getString("name"));
+    Money price;
+    if ((op == "set_price" || op == "add_product") && !Money::parse(request.getString("price"), price)) {
+        writeError(out, op, session, "Price must be a decimal amount");
+        return;
+    }
+    if ((op == "rename" || op == "add_product") && name.length() >= MAX_PRODUCT_NAME_LENGTH) {
+        writeError(out, op, session, "Product name is too long");
+        return;
+    }
+
+    engine.updateCatalog([&](ProductCatalog& catalog) {
+        if (op == "set_price") {
+            catalog.setPrice(code, price);
+        } else if (op == "rename") {
+            catalog.renameProduct(code, name.c_str());
+        } else if (op == "add_product") {
+            catalog.addProduct(Product(code.c_str(), name.c_str(), price));
+        } else {
+            catalog.removeProduct(code);
+        }
+    });
+
+    beginResult(out, op, session, true);
+    out << ",\"code\":";
+    writeJsonString(out, code);
+    out << ",\"version\":" << engine.getCatalog().read()->getVersion() << "}\n";
+}
+
+void ECommerceSystem::handleBatchCatalogStats(const string& session, ostream& out) {
+    CatalogUpdateStats stats = engine.getCatalog().getStats();
+    CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+
+    beginResult(out, "catalog_stats", session, true);
+    out << ",\"version\":" << catalog->getVersion()
+        << ",\"products\":" << catalog->getProductCount()
+        << ",\"updates\":" << stats.updates
+        << ",\"last_update_us\":" << stats.lastUpdateMicros
+        << ",\"max_update_us\":" << stats.maxUpdateMicros
+        << ",\"last_grace_wait_us\":" << stats.lastGraceWaitMicros
+        << ",\"max_grace_wait_us\":" << stats.maxGraceWaitMicros << "}\n";
+}
+
+void ECommerceSystem::handleBatchPaymentStats(const string& session, ostream& out) {
+    vector<PaymentProviderStats> stats = engine.getPayments().getStats();
+
+    beginResult(out, "payment_stats", session, true);
+    out << ",\"providers\":[";
+    for (size_t i = 0; i < stats.size(); i++) {
+        if (i > 0) out << ',';
+        out << "{\"id\":" << stats[i].id << ",\"method\":";
+        writeJsonString(out, stats[i].method);
+        out << ",\"payments\":" << stats[i].payments
+            << ",\"failures\":" << stats[i].failures
+            << ",\"retries\":" << stats[i].retries
+            << ",\"total_us\":" << stats[i].totalMicros
+            << ",\"max_us\":" << stats[i].maxMicros << '}';
+    }
+    out << "],\"gateways\":[";
+    for (size_t i = 0; i < mockGateways.size(); i++) {
+        MockGatewayStats gateway = mockGateways[i].second->getStats();
+        if (i > 0) out << ',';
+        out << "{\"id\":" << mockGateways[i].first
+            << ",\"captured\":" << gateway.captured
+            << ",\"replayed\":" << gateway.replayed
+            << ",\"injected_failures\":" << gateway.injectedFailures
+            << ",\"timeouts\":" << gateway.timeouts
+            << ",\"refunded\":" << gateway.refunded << '}';
+    }
+    out << "]}\n";
+}
+
+void ECommerceSystem::handleBatchMetrics(const BatchRequest& request, const string& session, ostream& out) {
+    beginResult(out, "metrics", session, true);
+    if (request.has("path")) {
+        Metrics::writeFile(string(request.getString("path")));
+        out << ",\"path\":";
+        writeJsonString(out, request.getString("path"));
+    } else {
+        out << ",\"report\":";
+        Metrics::writeJson(out);
+    }
+    out << "}\n";
+}
+
+void ECommerceSystem::handleBatchProduct(const BatchRequest& request, const string& session, ostream& out) {
+    string code(request.getString("code"));
+    for (char &c : code) {
+        c = toupper(c);
+    }
+    CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+    Result<const Product*> product = catalog->lookupProduct(code);
+    if (!product) {
+        writeError(out, "product", session, storeErrorMessage(product.getError()));
+        return;
+    }
+    beginResult(out, "product", session, true);
+    out << ",\"code\":";
+    writeJsonString(out, product.getValue()->getId());
+    out << ",\"name\":";
+    writeJsonString(out, product.getValue()->getName());
+    out << ",\"price\":" << product.getValue()->getPrice() << "}\n";
+}
+
+void ECommerceSystem::handleBatchSearch(const BatchRequest& request, const string& session, ostream& out) {
+    long long limit = 10;
+    if (request.has("limit") && (!request.getInt("limit", limit) || limit <= 0)) {
+        writeError(out, "search", session, "limit must be a positive number");
+        return;
+    }
+    vector<SearchHit> hits = engine.searchProducts(request.getString("q"), static_cast<size_t>(min(limit, 1000LL)));
+
+    CatalogHandle::ReadGuard catalog = engine.getCatalog().read();
+    beginResult(out, "search", session, true);
+    out << ",\"products\":[";
+    bool first = true;
+    for (const SearchHit& hit : hits) {
+        int slot = catalog->getIndex().find(ProductIndex::packCode(hit.code));
+        if (slot < 0) continue;
+        const Product& product = catalog->getProducts()[slot];
+        if (!first) out << ',';
+        first = false;
+        out << "{\"code\":";
+        writeJsonString(out, hit.code);
+        out << ",\"name\":";
+        writeJsonString(out, product.getName());
+        out << ",\"price\":" << product.getPrice() << ",\"score\":" << hit.score << '}';
+    }
+    out << "]}\n";
+}
+
+void ECommerceSystem::handleBatchTopProducts(const BatchRequest& request, const string& session, ostream& out) {
+    long long k = 5;
+    if (request.has("k") && (!request.getInt("k", k) || k <= 0)) {
+        writeError(out, "top_products", session, "k must be a positive number");
+        return;
+    }
+    vector<ProductSales> top = engine.getAnalytics().topProducts(static_cast<size_t>(min(k, 1000LL)));
+
+    beginResult(out, "top_products", session, true);
+    out << ",\"products\":[";
+    for (size_t i = 0; i < top.size(); i++) {
+        if (i > 0) out << ',';
+        out << "{\"code\":";
+        writeJsonString(out, top[i].code);
+        out << ",\"units\":" << top[i].units << ",\"gross_revenue\":" << top[i].grossRevenue << '}';
+    }
+    out << "]}\n";
+}
+
+void ECommerceSystem::handleBatchSalesByMethod(const string& session, ostream& out) {
+    vector<MethodSales> methods = engine.getAnalytics().revenueByMethod();
+
+    beginResult(out, "sales_by_method", session, true);
+    out << ",\"methods\":[";
+    for (size_t i = 0; i < methods.size(); i++) {
+        if (i > 0) out << ',';
+        out << "{\"method\":";
+        writeJsonString(out, methods[i].method);
+        out << ",\"orders\":" << methods[i].orders << ",\"net_revenue\":" << methods[i].netRevenue << '}';
+    }
+    out << "]}\n";
+}
+
+void ECommerceSystem::handleBatchSalesBetween(const BatchRequest& request, const string& session, ostream& out) {
+    long long from = 0;
+    long long to = 0;
+    if (!request.getInt("from", from) || !request.getInt("to", to)) {
+        writeError(out, "sales_between", session, "from and to must be numbers");
+        return;
+    }
+    bool exact = request.getString("exact") == "true";
+    const SalesAnalytics& analytics = engine.getAnalytics();
+    RangeSales sales = exact ? analytics.scanBetween(from, to) : analytics.salesBetween(from, to);
+
+    beginResult(out, "sales_between", session, true);
+    out << ",\"from\":" << from
+        << ",\"to\":" << to
+        << ",\"exact\":" << (exact ? "true" : "false")
+        << ",\"orders\":" << sales.orders
+        << ",\"net_revenue\":" << sales.netRevenue << "}\n";
+}
+
+void ECommerceSystem::handleBatchListOrders(const BatchRequest& request, const string& session, ostream& out) {
+    long long from = LLONG_MIN;
+    long long to = LLONG_MAX;
+    if ((request.has("from") && !request.getInt("from", from)) || (request.has("to") && !request.getInt("to", to))) {
+        writeError(out, "list_orders", session, "from and to must be Unix seconds");
+        return;
+    }
+    ReadSection reading;
+    vector<const Order*> orders = request.has("from") || request.has("to")
+        ? engine.getOrders().findBetween(from, to) : engine.getOrders().collect();
+
+    beginResult(out, "list_orders", session, true);
+    out << ",\"orders\":[";
+    for (size_t i = 0; i < orders.size(); i++) {
+        if (i > 0) out << ',';
+        out << "{\"order_id\":" << orders[i]->getOrderId()
+            << ",\"placed_at\":" << orders[i]->getPlacedAt()
+            << ",\"total\":" << orders[i]->getTotalAmount()
+            << ",\"discount\":" << orders[i]->getDiscountAmount()
+            << ",\"payment\":";
+        writeJsonString(out, orders[i]->getPaymentMethod());
+        out << '}';
+    }
+    out << "]}\n";
+}
+
+void ECommerceSystem::runHousekeeping(unordered_map<string, ShoppingCart>& sessions, ostream& out) {
+    expireIdleCarts(sessions);
+    saveChangedCarts(sessions);
+    try {
+        engine.compactIfDue();
+    } catch (const exception& e) {
+        writeError(out, "compact_orders", "", e.what());
+    }
+}
+
+void ECommerceSystem::saveChangedCarts(unordered_map<string, ShoppingCart>& sessions) {
+    if (!cartStore) return;
+    string records;
+    size_t count = 0;
+    for (pair<const string, ShoppingCart>& entry : sessions) {
+        if (!entry.second.hasChanges()) continue;
+        CartStore::encodeCart(entry.first, entry.second, records);
+        entry.second.markSaved();
+        count++;
+    }
+    cartStore->save(records, count);
+}
+
+void ECommerceSystem::expireIdleCarts(unordered_map<string, ShoppingCart>& sessions) {
+    long long now = steadySeconds();
+    for (pair<const string, ShoppingCart>& entry : sessions) {
+        if (entry.second.hasReservations() && !entry.second.isPaymentPending() &&
+            now - entry.second.getLastReservedAt() >= reservationTtlSeconds) {
+            entry.second.clear();
+        }
+    }
+}
+
+void ECommerceSystem::handleBatchSetStock(const BatchRequest& request, const string& session, ostream& out) {
+    string code(request.getString("code"));
+    for (char &c : code) {
+        c = toupper(c);
+    }
+    long long stock = 0;
+    if (!request.getInt("stock", stock) || stock < 0 || stock > INT_MAX) {
+        writeError(out, "set_stock", session, "Stock must be a non-negative number");
+        return;
+    }
+    engine.getCatalog().read()->findProductById(code);
+    engine.getInventory().setStock(code, static_cast<int>(stock));
+    writeStockResult("set_stock", code, session, out);
+}
+
+void ECommerceSystem::writeStockResult(const char* op, const string& code, const string& session, ostream& out) {
+    StockLevel level = engine.getInventory().getLevel(code);
+    beginResult(out, op, session, true);
+    out << ",\"code\":";
+    writeJsonString(out, code);
+    out << ",\"tracked\":" << (level.tracked ? "true" : "false");
+    if (level.tracked) {
+        out << ",\"on_hand\":" << level.onHand
+            << ",\"reserved\":" << level.reserved
+            << ",\"available\":" << max(level.onHand - level.reserved, 0);
+    }
+    out << "}\n";
+}
+
+void ECommerceSystem::handleBatchCartStats(const string& session, ostream& out) {
+    beginResult(out, "cart_stats", session, true);
+    out << ",\"enabled\":" << (cartStore ? "true" : "false");
+    if (cartStore) {
+        CartStoreStats stats = cartStore->getStats();
+        out << ",\"carts_saved\":" << stats.cartsSaved
+            << ",\"writes\":" << stats.writes
+            << ",\"failed_writes\":" << stats.failedWrites
+            << ",\"pending_bytes\":" << stats.pendingBytes;
+    }
+    out << "}\n";
+}
+
+void ECommerceSystem::processBatchRequest(const BatchRequest& request, unordered_map<string, ShoppingCart>& sessions,
+                                          CheckoutQueue& checkouts, ostream& out) {
+    string_view op = request.getString("op");
+    string session(request.getString("session"));
+
+    try {
+        if (op == "add") {
+            handleBatchAdd(request, session, sessionCart(sessions, session), out);
+        } else if (op == "add_many") {
+            handleBatchAddMany(request, session, sessionCart(sessions, session), out);
+        } else if (op == "reorder") {
+            handleBatchReorder(request, session, sessionCart(sessions, session), out);
+        } else if (op == "checkout") {
+            handleBatchCheckout(request, session, sessionCart(sessions, session), checkouts, out);
+        } else if (op == "list_orders") {
+            handleBatchListOrders(request, session, out);
+        } else if (op == "set_price" || op == "rename" || op == "add_product" || op == "remove_product") {
+            handleBatchCatalogUpdate(op, request, session, out);
+        } else if (op == "catalog_stats") {
+            handleBatchCatalogStats(session, out);
+        } else if (op == "payment_stats") {
+            handleBatchPaymentStats(session, out);
+        } else if (op == "set_stock") {
+            handleBatchSetStock(request, session, out);
+        } else if (op == "stock") {
+            string code(request.getString("code"));
+            for (char &c : code) {
+                c = toupper(c);
+            }
+            writeStockResult("stock", code, session, out);
+        } else if (op == "compact_orders") {
+            size_t evicted = engine.compactOrders();
+            beginResult(out, op, session, true);
+            out << ",\"evicted\":" << evicted << ",\"retained\":" << engine.getOrders().size() << "}\n";
+        } else if (op == "quote") {
+            handleBatchQuote(request, session, sessionCart(sessions, session), out);
+        } else if (op == "add_promo") {
+            handleBatchAddPromotion(request, session, out);
+        } else if (op == "remove_promo") {
+            long long id = 0;
+            if (!request.getInt("id", id) || !engine.getPromotions().remove(static_cast<int>(id))) {
+                writeError(out, op, session, "Unknown promotion");
+            } else {
+                beginResult(out, op, session, true);
+                out << ",\"id\":" << id << "}\n";
+            }
+        } else if (op == "list_promos") {
+            handleBatchListPromotions(session, out);
+        } else if (op == "product") {
+            handleBatchProduct(request, session, out);
+        } else if (op == "search") {
+            handleBatchSearch(request, session, out);
+        } else if (op == "top_products") {
+            handleBatchTopProducts(request, session, out);
+        } else if (op == "sales_by_method") {
+            handleBatchSalesByMethod(session, out);
+        } else if (op == "sales_between") {
+            handleBatchSalesBetween(request, session, out);
+        } else if (op == "metrics") {
+            handleBatchMetrics(request, session, out);
+        } else if (op == "cart_stats") {
+            handleBatchCartStats(session, out);
+        } else if (op == "log_stats") {
+            LoggerStats stats = OrderLogger::getInstance()->getStats();
+            beginResult(out, op, session, true);
+            out << ",\"queue_depth\":" << stats.queueDepth
+                << ",\"enqueued\":" << stats.enqueued
+                << ",\"written\":" << stats.written
+                << ",\"dropped\":" << stats.dropped
+                << ",\"batches\":" << stats.batches << "}\n";
+        } else if (op == "clear") {
+            sessionCart(sessions, session).clear();
+            beginResult(out, op, session, true);
+            out << "}\n";
+        } else {
+            writeError(out, op, session, "Unknown operation");
+        }
+    } catch (const exception& e) {
+        writeError(out, op, session, e.what());
+    }
+}
+
+void ECommerceSystem::flushBatchOutput(BatchWorker& worker, ostream& results) {
+    string text = worker.output.str();
+    if (!text.empty()) {
+        lock_guard<mutex> guard(outputLock);
+        results.write(text.data(), static_cast<streamsize>(text.size()));
+    }
+    worker.output.str("");
+}
+
+void ECommerceSystem::runBatchWorker(BatchWorker& worker, ostream& results) {
+    deque<BatchRequest> batch;
+
+    for (;;) {
+        {
+            unique_lock<mutex> guard(worker.lock);
+            worker.hasWork.wait(guard, [&worker]() { return !worker.pending.empty() || worker.closing; });
+            if (worker.pending.empty()) break;
+            batch.swap(worker.pending);
+        }
+        worker.hasSpace.notify_one();
+
+        for (const BatchRequest& request : batch) {
+            runBatchRequest(request, worker.sessions, worker.checkouts, worker.output);
+            if (++worker.processed % EXPIRY_SWEEP_REQUESTS == 0) {
+                settleCheckouts(worker.checkouts, worker.output);
+                runHousekeeping(worker.sessions, worker.output);
+            }
+        }
+        batch.clear();
+
+        if (worker.output.tellp() > OUTPUT_FLUSH_BYTES) {
+            flushBatchOutput(worker, results);
+        }
+    }
+    settleCheckouts(worker.checkouts, worker.output);
+    saveChangedCarts(worker.sessions);
+    flushBatchOutput(worker, results);
+}
+
+ECommerceSystem::ECommerceSystem(const MockGatewayConfig& gatewayConfig,
+                                 const PaymentPolicy& paymentPolicy)
+    : cart(&engine.getInventory()), reservationTtlSeconds(900) {
+    mockGateways.push_back(make_pair(2, make_shared<MockPaymentGateway>(gatewayConfig)));
+    mockGateways.push_back(make_pair(3, make_shared<MockPaymentGateway>(gatewayConfig)));
+
+    PaymentRegistry& payments = engine.getPayments();
+    payments.registerProvider(1, "💵", unique_ptr<PaymentStrategy>(new CashPayment()));
+    payments.registerProvider(2, "💳", unique_ptr<PaymentStrategy>(new CardPayment()), mockGateways[0].second, paymentPolicy);
+    payments.registerProvider(3, "📱", unique_ptr<PaymentStrategy>(new GCashPayment()), mockGateways[1].second, paymentPolicy);
+}
+
+size_t ECommerceSystem::openCartStore(const string& path) {
+    cartStore.reset(new CartStore(path));
+    return cartStore->recover([this](string_view session, const CartItem* lines, size_t count) {
+        ShoppingCart& restored = restoredCarts.try_emplace(string(session), &engine.getInventory()).first->second;
+        restored.restore(lines, count);
+    });
+}
+
+void ECommerceSystem::runBatch(istream& in, ostream& out, int threadCount) {
+    ostream results(out.rdbuf());
+    string line;
+    BatchRequest request;
+
+    OrderLogger::getInstance();
+
+    if (threadCount <= 1) {
+        unordered_map<string, ShoppingCart> sessions;
+        sessions.swap(restoredCarts);
+        CheckoutQueue checkouts;
+        unsigned long long processed = 0;
+        while (getline(in, line)) {
+            if (line.find_first_not_of(" \t\r") == string::npos) continue;
+
+            if (!request.parse(line)) {
+                writeError(results, "", "", "Malformed request");
+                continue;
+            }
+            runBatchRequest(request, sessions, checkouts, results);
+            if (++processed % EXPIRY_SWEEP_REQUESTS == 0) {
+                settleCheckouts(checkouts, results);
+                runHousekeeping(sessions, results);
+            }
+        }
+        settleCheckouts(checkouts, results);
+        saveChangedCarts(sessions);
+        results.flush();
+        return;
+    }
+
+    hash<string_view> sessionHash;
+    vector<unique_ptr<BatchWorker>> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(new BatchWorker());
+    }
+    for (pair<const string, ShoppingCart>& entry : restoredCarts) {
+        workers[sessionHash(entry.first) % workers.size()]->sessions.emplace(entry.first, move(entry.second));
+    }
+    restoredCarts.clear();
+    for (unique_ptr<BatchWorker>& worker : workers) {
+        worker->runner = thread(&ECommerceSystem::runBatchWorker, this, ref(*worker), ref(results));
+    }
+    while (getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+
+        if (!request.parse(line)) {
+            lock_guard<mutex> guard(outputLock);
+            writeError(results, "", "", "Malformed request");
+            continue;
+        }
+
+        BatchWorker& worker = *workers[sessionHash(request.getString("session")) % workers.size()];
+        {
+            unique_lock<mutex> guard(worker.lock);
+            worker.hasSpace.wait(guard, [&worker]() { return worker.pending.size() < MAX_PENDING_REQUESTS; });
+            worker.pending.push_back(request);
+        }
+        worker.hasWork.notify_one();
+    }
+
+    for (unique_ptr<BatchWorker>& worker : workers) {
+        {
+            lock_guard<mutex> guard(worker->lock);
+            worker->closing = true;
+        }
+        worker->hasWork.notify_one();
+    }
+    for (unique_ptr<BatchWorker>& worker : workers) {
+        worker->runner.join();
+    }
+    results.flush();
+}
+
+void ECommerceSystem::saveInteractiveCart() {
+    if (!cartStore || !cart.hasChanges()) return;
+    string records;
+    CartStore::encodeCart("", cart, records);
+    cart.markSaved();
+    cartStore->save(records, 1);
+}
+
+void ECommerceSystem::run() {
+    int choice = 0;
+    bool exitProgram = false;
+
+    unordered_map<string, ShoppingCart>::iterator restored = restoredCarts.find("");
+    if (restored != restoredCarts.end()) {
+        cart = move(restored->second);
+    }
+    restoredCarts.clear();
+    
+    while (!exitProgram) {
+        try {
+            displayMainMenu();
+            choice = getValidInput("➡ Enter your choice (1-4): ", 1, 4);
+
+            switch (choice) {
+                case 1: handleViewProducts(); break;
+                case 2: handleViewCart(); break;
+                case 3: handleViewOrders(); break;
+                case 4: 
+                    cout << "╔════════════════════════════════════════════╗\n";
+                    cout << "║          🛑 THANK YOU FOR SHOPPING!       ║\n";
+                    cout << "╚════════════════════════════════════════════╝\n";
+                    exitProgram = true;
+                    break;
+            }
+        } catch (const exception& e) {
+            cout << "╔════════════════════════════════════════════╗\n";
+            cout << "║               ❗ ERROR:                     ║\n";
+            cout << "║ " << left << setw(40) << e.what() << " ║\n";
+            cout << "╚════════════════════════════════════════════╝\n";
+        }
+        saveInteractiveCart();
+    }
+}
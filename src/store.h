@@ -0,0 +1,168 @@
+#ifndef STORE_STORE_H
+#define STORE_STORE_H
+
+#include "engine.h"
+
+// ==================== ECOMMERCE SYSTEM ====================
+class ECommerceSystem {
+private:
+    struct PendingCheckout {
+        string session;
+        ShoppingCart* cart;
+        int orderId;
+        int method;
+        CartPricing pricing;
+        future<PaymentResult> payment;
+        int owner = -1;
+    };
+
+    struct CheckoutQueue {
+        deque<PendingCheckout> pending;
+        function<void()> notify;
+    };
+
+    // Sessions are pinned to one worker by a hash of their ID.
+    struct BatchWorker {
+        thread runner;
+        mutex lock;
+        condition_variable hasWork;
+        condition_variable hasSpace;
+        deque<BatchRequest> pending;
+        bool closing;
+        unordered_map<string, ShoppingCart> sessions;
+        CheckoutQueue checkouts;
+        ostringstream output;
+        unsigned long long processed;
+
+        BatchWorker() : closing(false), processed(0) {}
+    };
+
+    static const size_t MAX_PENDING_REQUESTS = 4096;
+    static const long OUTPUT_FLUSH_BYTES = 65536;
+    static const int EXPIRY_SWEEP_REQUESTS = 1024;
+    static const size_t MAX_INFLIGHT_CHECKOUTS = 256;
+
+    vector<pair<int, shared_ptr<MockPaymentGateway>>> mockGateways;
+    StoreEngine engine;
+    ShoppingCart cart;
+    mutex outputLock;
+    int reservationTtlSeconds;
+    RenderBuffer screen;
+    unique_ptr<CartStore> cartStore;
+    unordered_map<string, ShoppingCart> restoredCarts;
+
+    void displayMainMenu();
+    void displaySearchResults(string_view query);
+    void handleViewProducts();
+    void handleViewCart();
+    void checkout();
+    void handleViewOrders();
+    void displaySalesSummary(const ProductCatalog& catalog);
+    static void beginResult(ostream& out, string_view op, string_view session, bool ok);
+
+    static void writeError(ostream& out, string_view op, string_view session, const char* message) {
+        beginResult(out, op, session, false);
+        out << ",\"error\":";
+        writeJsonString(out, message);
+        out << "}\n";
+    }
+
+    void handleBatchAdd(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out);
+    void handleBatchAddMany(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out);
+    void handleBatchReorder(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out);
+
+    // Starts the payment; finishBatchCheckout() places the order once it settles.
+    void handleBatchCheckout(const BatchRequest& request, const string& session, ShoppingCart& sessionCart,
+                             CheckoutQueue& checkouts, ostream& out);
+
+    void finishBatchCheckout(PendingCheckout& checkout, ostream& out);
+    void settleCheckouts(CheckoutQueue& checkouts, ostream& out, const ShoppingCart* cart = nullptr);
+    void settleReadyCheckouts(CheckoutQueue& checkouts, ostream& out);
+
+    static bool isSessionOp(string_view op) {
+        return op == "add" || op == "add_many" || op == "reorder" || op == "checkout" || op == "quote" || op == "clear";
+    }
+
+    // Waits for a pending checkout first when the request depends on it.
+    void runBatchRequest(const BatchRequest& request, unordered_map<string, ShoppingCart>& sessions,
+                         CheckoutQueue& checkouts, ostream& out);
+
+    static void writePricing(ostream& out, const CartPricing& pricing);
+
+    Result<const char*> lookupPaymentMethod(const BatchRequest& request, long long& paymentChoice) {
+        if (!request.getInt("payment", paymentChoice)) {
+            return StoreError::InvalidInput;
+        }
+        return engine.getPayments().lookupMethodName(static_cast<int>(paymentChoice));
+    }
+
+    void handleBatchQuote(const BatchRequest& request, const string& session, ShoppingCart& sessionCart, ostream& out);
+    void handleBatchAddPromotion(const BatchRequest& request, const string& session, ostream& out);
+    void handleBatchListPromotions(const string& session, ostream& out);
+    void handleBatchCatalogUpdate(string_view op, const BatchRequest& request, const string& session, ostream& out);
+    void handleBatchCatalogStats(const string& session, ostream& out);
+    void handleBatchPaymentStats(const string& session, ostream& out);
+    void handleBatchMetrics(const BatchRequest& request, const string& session, ostream& out);
+    void handleBatchProduct(const BatchRequest& request, const string& session, ostream& out);
+    void handleBatchSearch(const BatchRequest& request, const string& session, ostream& out);
+    void handleBatchTopProducts(const BatchRequest& request, const string& session, ostream& out);
+    void handleBatchSalesByMethod(const string& session, ostream& out);
+    void handleBatchSalesBetween(const BatchRequest& request, const string& session, ostream& out);
+    void handleBatchListOrders(const BatchRequest& request, const string& session, ostream& out);
+
+    ShoppingCart& sessionCart(unordered_map<string, ShoppingCart>& sessions, const string& session) {
+        return sessions.try_emplace(session, &engine.getInventory()).first->second;
+    }
+
+    void runHousekeeping(unordered_map<string, ShoppingCart>& sessions, ostream& out);
+    void saveChangedCarts(unordered_map<string, ShoppingCart>& sessions);
+    void expireIdleCarts(unordered_map<string, ShoppingCart>& sessions);
+    void handleBatchSetStock(const BatchRequest& request, const string& session, ostream& out);
+    void writeStockResult(const char* op, const string& code, const string& session, ostream& out);
+    void handleBatchCartStats(const string& session, ostream& out);
+
+    void processBatchRequest(const BatchRequest& request, unordered_map<string, ShoppingCart>& sessions,
+                             CheckoutQueue& checkouts, ostream& out);
+
+    void flushBatchOutput(BatchWorker& worker, ostream& results);
+    void runBatchWorker(BatchWorker& worker, ostream& results);
+
+public:
+    // Card and GCash go through mock gateways.
+    explicit ECommerceSystem(const MockGatewayConfig& gatewayConfig = MockGatewayConfig(),
+                             const PaymentPolicy& paymentPolicy = PaymentPolicy());
+
+    void loadCatalog(const string& path) {
+        engine.loadCatalog(path);
+    }
+
+    void setStockForAll(int onHand) {
+        engine.setStockForAll(onHand);
+    }
+
+    void setReservationTtl(int seconds) {
+        reservationTtlSeconds = seconds;
+    }
+
+    void openJournal(const string& path) {
+        engine.openJournal(path);
+    }
+
+    void setRetention(const OrderRetention& retention) {
+        engine.setRetention(retention);
+    }
+
+    // Call after stock is set up.
+    size_t openCartStore(const string& path);
+
+    // Headless mode: one JSON request per input line, one JSON result per output line.
+    void runBatch(istream& in, ostream& out, int threadCount = 1);
+
+    // Serves the batch protocol on 127.0.0.1:port until SIGINT or SIGTERM.
+    void runServer(int port);
+
+    void saveInteractiveCart();
+    void run();
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include "test_support.h"
+
+// ==================== ANALYTICS TESTS ====================
+void runAnalyticsTests(TestSuite& suite) {
+    suite.scenario("analytics", [&]() {
+        ECommerceSystem system;
+        vector<string> requests;
+        requests.push_back("{\"op\":\"add_promo\",\"type\":\"percent\",\"code\":\"LAP\",\"percent\":\"10\"}");
+        checkoutRequests("a", "LAP", 2, 1, requests);
+        checkoutRequests("b", "MOU", 1, 1, requests);
+        requests.push_back("{\"op\":\"top_products\",\"k\":2}");
+        requests.push_back("{\"op\":\"sales_by_method\"}");
+        requests.push_back("{\"op\":\"sales_between\",\"from\":0,\"to\":9000000000000,\"exact\":\"true\"}");
+        requests.push_back("{\"op\":\"sales_between\",\"from\":0,\"to\":9000000000000}");
+        vector<string> results = runTestBatch(system, requests);
+
+        suite.check("analytics: the discounted order is placed",
+                    hasText(results, 2, "\"total\":9000.00,\"payment\":\"Cash\",\"subtotal\":10000.00,\"discount\":1000.00"));
+        suite.check("analytics: product revenue is gross of discounts",
+                    hasText(results, 5, "{\"code\":\"LAP\",\"units\":2,\"gross_revenue\":10000.00},{\"code\":\"MOU\",\"units\":1,\"gross_revenue\":800.00}"));
+        suite.check("analytics: method revenue is net of discounts",
+                    hasText(results, 6, "{\"method\":\"Cash\",\"orders\":2,\"net_revenue\":9800.00}"));
+        suite.check("analytics: the column scan matches the method totals", hasText(results, 7, "\"orders\":2,\"net_revenue\":9800.00}"));
+        suite.check("analytics: the hourly timeline matches the column scan", hasText(results, 8, "\"orders\":2,\"net_revenue\":9800.00}"));
+    });
+}
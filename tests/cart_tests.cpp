@@ -0,0 +1,102 @@
+#include "test_support.h"
+
+// ==================== CART TESTS ====================
+void runCartTests(TestSuite& suite) {
+    suite.scenario("bulk add", [&]() {
+        // Prices above INT32_MAX catch a signed lane multiply.
+        ProductCatalog catalog;
+        catalog.addProduct(Product("BIG", "Top Price", Money::fromCents(UINT32_MAX)));
+        catalog.addProduct(Product("ODD", "Odd Price", Money::fromCents(2147483649LL)));
+        const char* pool[] = {"BIG", "LAP", "ODD", "SPK", "USB", "HDD", "BIG"};
+
+        bool matches = true;
+        for (size_t count = 1; count <= 13; count++) {
+            vector<const char*> codes;
+            vector<int> quantities;
+            Money expected;
+            for (size_t i = 0; i < count; i++) {
+                codes.push_back(pool[i % 7]);
+                quantities.push_back(static_cast<int>(100000 + i * 7919));
+                const Product& product = catalog.getProducts()[catalog.getIndex().find(ProductIndex::packCode(codes[i]))];
+                expected += product.getPrice() * quantities[i];
+            }
+            ShoppingCart cart;
+            cart.addProducts(catalog, codes.data(), quantities.data(), count);
+            matches = matches && cart.calculateTotal() == expected;
+        }
+        suite.check("bulk add: the 32-bit column sum matches checked Money for every tail length", matches);
+
+        ShoppingCart cart;
+        const char* codes[] = {"BIG", "ODD"};
+        int quantities[] = {INT_MAX, INT_MAX};
+        bool overflowed = false;
+        try {
+            cart.addProducts(catalog, codes, quantities, 2);
+        } catch (const overflow_error&) {
+            overflowed = true;
+        }
+        suite.check("bulk add: totals too large for the column sum still report overflow", overflowed);
+    });
+
+    suite.scenario("cart file", [&]() {
+        string carts = suite.scratchFile("carts.bin");
+        {
+            ECommerceSystem system;
+            system.openCartStore(carts);
+            runTestBatch(system, {
+                "{\"op\":\"add\",\"session\":\"a\",\"code\":\"LAP\",\"qty\":2}",
+                "{\"op\":\"add\",\"session\":\"b\",\"code\":\"MOU\",\"qty\":1}",
+                "{\"op\":\"add\",\"session\":\"c\",\"code\":\"LAP\",\"qty\":1}",
+                "{\"op\":\"clear\",\"session\":\"c\"}",
+            });
+        }
+        const vector<string> quotes = {
+            "{\"op\":\"quote\",\"session\":\"a\",\"payment\":1}",
+            "{\"op\":\"quote\",\"session\":\"b\",\"payment\":1}",
+            "{\"op\":\"quote\",\"session\":\"c\",\"payment\":1}",
+        };
+        {
+            ECommerceSystem system;
+            suite.check("carts: open carts survive a restart", system.openCartStore(carts) == 2);
+            vector<string> results = runTestBatch(system, quotes);
+            suite.check("carts: restored carts keep their lines",
+                        hasText(results, 0, "\"total\":10000.00") && hasText(results, 1, "\"total\":800.00"));
+            suite.check("carts: a cleared cart stays empty", hasText(results, 2, "\"total\":0.00"));
+        }
+
+        string data = readTestFile(carts);
+        for (size_t frame : listFrames(data, sizeof(CartFileHeader))) {
+            uint32_t sessionLength;
+            memcpy(&sessionLength, data.data() + frame + 9, sizeof(sessionLength));
+            if (string_view(data.data() + frame + 13, sessionLength) != "b") continue;
+            data[frame + 13 + sessionLength + 4 + PRODUCT_CODE_LENGTH] = 'X';
+            resealFrame(data, frame);
+        }
+        data += string("\x20\x00\x00\x00\x01", 5);
+        writeTestFile(carts, data);
+        {
+            ECommerceSystem system;
+            suite.check("carts: a record with an unterminated code is dropped", system.openCartStore(carts) == 1);
+            vector<string> results = runTestBatch(system, quotes);
+            suite.check("carts: other carts still recover",
+                        hasText(results, 0, "\"total\":10000.00") && hasText(results, 1, "\"total\":0.00"));
+        }
+    });
+
+    suite.scenario("stock", [&]() {
+        ECommerceSystem system;
+        vector<string> results = runTestBatch(system, {
+            "{\"op\":\"set_stock\",\"code\":\"LAP\",\"stock\":3}",
+            "{\"op\":\"add\",\"session\":\"x\",\"code\":\"LAP\",\"qty\":2}",
+            "{\"op\":\"add\",\"session\":\"y\",\"code\":\"LAP\",\"qty\":2}",
+            "{\"op\":\"stock\",\"code\":\"LAP\"}",
+            "{\"op\":\"clear\",\"session\":\"x\"}",
+            "{\"op\":\"stock\",\"code\":\"LAP\"}",
+        });
+        suite.check("stock: a reservation beyond what is available fails", hasText(results, 2, "\"ok\":false"));
+        suite.check("stock: reserved units are not available",
+                    hasText(results, 3, "\"on_hand\":3,\"reserved\":2,\"available\":1"));
+        suite.check("stock: clearing a cart releases its reservation",
+                    hasText(results, 5, "\"reserved\":0,\"available\":3"));
+    });
+}
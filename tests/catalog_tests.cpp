@@ -0,0 +1,56 @@
+#include "test_support.h"
+
+// ==================== CATALOG TESTS ====================
+static string convertError(const string& csv, const string& binary) {
+    try {
+        convertCatalogCsv(csv, binary);
+    } catch (const runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+void runCatalogTests(TestSuite& suite) {
+    suite.scenario("catalog csv", [&]() {
+        string csv = suite.scratchFile("catalog.csv");
+        string binary = suite.scratchFile("catalog.bin");
+
+        writeTestFile(csv, "code,name,price\nab1,Cable,12.50\n\"CAM\",\"Camera, 4K\",9999.99\n");
+        size_t count = convertCatalogCsv(csv, binary);
+        ProductCatalog catalog;
+        catalog.loadBinary(binary);
+        int slot = catalog.getIndex().find(ProductIndex::packCode("AB1"));
+        suite.check("catalog csv: lowercase codes are stored uppercase",
+                    count == 2 && slot >= 0 && strcmp(catalog.getProducts()[slot].getId(), "AB1") == 0);
+        suite.check("catalog csv: quoted names keep their commas",
+                    catalog.getIndex().find(ProductIndex::packCode("CAM")) >= 0);
+
+        writeTestFile(csv, "code,name,price\nAB1,Cable,12.50\nA-1,Dash,1.00\n");
+        suite.check("catalog csv: codes outside A-Z and 0-9 are rejected with their line",
+                    convertError(csv, binary) == "Invalid product code at line 3.");
+
+        writeTestFile(csv, "AB1,Cable,12.50\nab1,Cable,12.50\n");
+        suite.check("catalog csv: codes that differ only in case are duplicates",
+                    convertError(csv, binary) == "Duplicate product code at line 2.");
+
+        writeTestFile(csv, "AB12,Cable,12.50\n");
+        suite.check("catalog csv: codes of the wrong length are rejected with their line",
+                    convertError(csv, binary) == "Malformed CSV catalog at line 1.");
+    });
+
+    suite.scenario("lookups", [&]() {
+        ECommerceSystem system;
+        vector<string> results = runTestBatch(system, {
+            "{\"op\":\"add\",\"session\":\"z\",\"code\":\"ZZZ\",\"qty\":1}",
+            "{\"op\":\"add_many\",\"session\":\"z\",\"codes\":\"LAP,ZZZ\",\"qtys\":\"1,1\"}",
+            "{\"op\":\"quote\",\"session\":\"z\",\"payment\":1}",
+            "{\"op\":\"checkout\",\"session\":\"z\",\"payment\":1}",
+        });
+        string notFound = storeErrorMessage(StoreError::ProductNotFound);
+        suite.check("lookups: an unknown code is reported, not thrown", hasText(results, 0, notFound));
+        suite.check("lookups: a bulk add with an unknown code changes nothing",
+                    hasText(results, 1, notFound) && hasText(results, 2, "\"total\":0.00"));
+        suite.check("lookups: an empty cart cannot check out",
+                    hasText(results, 3, storeErrorMessage(StoreError::EmptyCart)));
+    });
+}
@@ -0,0 +1,118 @@
+#include "test_support.h"
+
+// ==================== COMPACTION TESTS ====================
+static bool sortedById(const vector<const Order*>& orders) {
+    for (size_t i = 1; i < orders.size(); i++) {
+        if (orders[i - 1]->getOrderId() >= orders[i]->getOrderId()) return false;
+    }
+    return true;
+}
+
+void runCompactionTests(TestSuite& suite) {
+    suite.scenario("compaction", [&]() {
+        string journal = suite.scratchFile("retained.journal");
+        OrderRetention retention;
+        retention.maxOrders = 2;
+        string beforeCompaction;
+        {
+            ECommerceSystem system;
+            system.openJournal(journal);
+            system.setRetention(retention);
+            vector<string> requests;
+            for (int i = 0; i < 5; i++) {
+                checkoutRequests("s" + to_string(i), "LAP", 1, 1, requests);
+            }
+            runTestBatch(system, requests);
+            beforeCompaction = readTestFile(journal);
+
+            requests.assign(1, "{\"op\":\"compact_orders\"}");
+            requests.push_back(LIST_ORDERS);
+            requests.push_back("{\"op\":\"sales_by_method\"}");
+            vector<string> results = runTestBatch(system, requests);
+            suite.check("compaction: evicts all but the newest orders", hasText(results, 0, "\"evicted\":3,\"retained\":2"));
+            suite.check("compaction: list_orders returns only retained orders",
+                        countText(results[1], "\"order_id\":") == 2 && hasText(results, 1, "\"order_id\":5,"));
+            suite.check("compaction: evicted orders still count in reports", hasText(results, 2, "\"orders\":5"));
+            suite.check("compaction: evicted orders are archived",
+                        listFrames(readTestFile(journal + ".archive"), 0).size() == 3);
+        }
+        {
+            ECommerceSystem system;
+            system.openJournal(journal);
+            system.setRetention(retention);
+            vector<string> requests(1, LIST_ORDERS);
+            checkoutRequests("t", "LAP", 1, 1, requests);
+            vector<string> results = runTestBatch(system, requests);
+            suite.check("compaction: a restart keeps archived orders out of memory", countText(results[0], "\"order_id\":") == 2);
+            suite.check("compaction: order IDs continue past archived orders", hasText(results, 2, "\"order_id\":6,"));
+        }
+
+        // Crash between archiving and the snapshot.
+        filesystem::remove(journal + ".snapshot");
+        writeTestFile(journal, beforeCompaction);
+        {
+            ECommerceSystem system;
+            system.openJournal(journal);
+            vector<string> results = runTestBatch(system, vector<string>(1, LIST_ORDERS));
+            suite.check("compaction: an interrupted compaction restores no order twice",
+                        countText(results[0], "\"order_id\":") == 2);
+        }
+    });
+
+    suite.scenario("order store eviction", [&]() {
+        // Enough orders that scans run on the pool.
+        const int ORDERS = 70000;
+        OrderStore store(4, 4);
+        JournalOrder order;
+        order.paymentMethod = "Cash";
+        order.total = Money::fromUnits(5000);
+        order.lines.resize(1);
+        memcpy(order.lines[0].code, "LAP", PRODUCT_CODE_LENGTH + 1);
+        order.lines[0].quantity = 1;
+        order.lines[0].unitPrice = order.total;
+        for (int id = 1; id <= ORDERS; id++) {
+            order.orderId = id;
+            order.placedAt = 1000 + id;
+            store.restore(order);
+        }
+        // Old, but queued behind newer orders in its shard.
+        order.orderId = ORDERS + 1;
+        order.placedAt = 1;
+        store.restore(order);
+
+        bool scansAgree = true;
+        for (int i = 0; i < 3; i++) {
+            vector<const Order*> all = store.collect();
+            scansAgree = scansAgree && all.size() == store.size() && sortedById(all);
+        }
+        suite.check("order store: repeated parallel scans return every order in ID order", scansAgree);
+
+        OrderRetention byAge;
+        byAge.maxAgeSeconds = 100;
+        vector<const Order*> expired = store.findExpired(byAge, 1000 + 60000 + 100);
+        suite.check("order store: orders past the age limit expire from the front of each shard",
+                    expired.size() == 59999 && sortedById(expired) && expired.back()->getOrderId() == 59999);
+
+        vector<int> ids;
+        for (const Order* old : expired) {
+            ids.push_back(old->getOrderId());
+        }
+        store.evict(ids);
+        suite.check("order store: eviction drops the expired prefix",
+                    store.size() == static_cast<size_t>(ORDERS + 1 - 59999) && store.find(59999) == nullptr &&
+                    store.find(60000) != nullptr && store.collect().size() == store.size());
+        suite.check("order store: an old order behind newer ones waits", store.find(ORDERS + 1) != nullptr);
+
+        OrderRetention byCount;
+        byCount.maxOrders = 10;
+        expired = store.findExpired(byCount, 0);
+        ids.clear();
+        for (const Order* old : expired) {
+            ids.push_back(old->getOrderId());
+        }
+        store.evict(ids);
+        vector<const Order*> kept = store.collect();
+        suite.check("order store: maxOrders keeps the newest order IDs",
+                    kept.size() == 10 && store.size() == 10 && kept.front()->getOrderId() == ORDERS - 8);
+    });
+}
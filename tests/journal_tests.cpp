@@ -0,0 +1,62 @@
+#include "test_support.h"
+
+// ==================== JOURNAL TESTS ====================
+void runJournalTests(TestSuite& suite) {
+    suite.scenario("journal", [&]() {
+        // Runs first, so the threads race to build the CRC table.
+        const char* check = "123456789";
+        atomic<int> matches(0);
+        vector<thread> threads;
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back([&]() {
+                if (OrderJournal::crc32(check, strlen(check)) == 0xCBF43926u) matches++;
+            });
+        }
+        for (thread& t : threads) t.join();
+        suite.check("journal: crc32 gives the standard check value on every thread", matches == 4);
+
+        string journal = suite.scratchFile("orders.journal");
+        {
+            ECommerceSystem system;
+            system.openJournal(journal);
+            vector<string> requests;
+            checkoutRequests("a", "LAP", 1, 1, requests);
+            checkoutRequests("b", "MOU", 2, 1, requests);
+            checkoutRequests("c", "LAP", 1, 1, requests);
+            runTestBatch(system, requests);
+        }
+        {
+            ECommerceSystem system;
+            system.openJournal(journal);
+            vector<string> requests(1, LIST_ORDERS);
+            checkoutRequests("d", "LAP", 1, 1, requests);
+            vector<string> results = runTestBatch(system, requests);
+            suite.check("journal: placed orders survive a restart", countText(results[0], "\"order_id\":") == 3);
+            suite.check("journal: order IDs continue after replay", hasText(results, 2, "\"order_id\":4,"));
+        }
+
+        string data = readTestFile(journal);
+        writeTestFile(journal, data.substr(0, data.size() - 3));
+        {
+            ECommerceSystem system;
+            system.openJournal(journal);
+            vector<string> requests(1, LIST_ORDERS);
+            checkoutRequests("e", "LAP", 1, 1, requests);
+            vector<string> results = runTestBatch(system, requests);
+            suite.check("journal: a torn last record is dropped", countText(results[0], "\"order_id\":") == 3);
+            suite.check("journal: the torn order's ID is issued again", hasText(results, 2, "\"order_id\":4,"));
+        }
+
+        data = readTestFile(journal);
+        vector<size_t> frames = listFrames(data, 0);
+        suite.check("journal: one record per order", frames.size() == 4);
+        data[frames[1] + 8 + 2] ^= 0x5A;
+        writeTestFile(journal, data);
+        {
+            ECommerceSystem system;
+            system.openJournal(journal);
+            vector<string> results = runTestBatch(system, vector<string>(1, LIST_ORDERS));
+            suite.check("journal: replay stops at a record with a bad checksum", countText(results[0], "\"order_id\":") == 1);
+        }
+    });
+}
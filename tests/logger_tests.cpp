@@ -0,0 +1,46 @@
+#include "test_support.h"
+
+// ==================== LOGGER TESTS ====================
+void runLoggerTests(TestSuite& suite) {
+    suite.scenario("async logger", [&]() {
+        LoggerConfig config;
+        config.path = suite.scratchFile("orders.log");
+        config.async = true;
+        config.queueCapacity = 1024;
+        config.flushIntervalMs = 60000;
+        config.maxBatchRecords = 8;
+        OrderLogger::shutdown();
+        OrderLogger::configure(config);
+
+        // Give the writer time to park on the empty ring first.
+        OrderLogger::getInstance();
+        this_thread::sleep_for(chrono::milliseconds(20));
+        OrderLogger::getInstance()->logOrder(1, "Cash");
+        bool woke = false;
+        for (int wait = 0; wait < 2000 && !woke; wait++) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            woke = OrderLogger::getInstance()->getStats().written == 1;
+        }
+        suite.check("logger: a record pushed into an empty ring wakes the writer", woke);
+
+        for (int i = 2; i <= 1000; i++) {
+            OrderLogger::getInstance()->logOrder(i, "GCash");
+        }
+        LoggerStats stats;
+        for (int wait = 0; wait < 2000; wait++) {
+            stats = OrderLogger::getInstance()->getStats();
+            if (stats.written + stats.dropped == 1000) break;
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        suite.check("logger: every record is written", stats.written == 1000 && stats.dropped == 0);
+        suite.check("logger: batches stop at maxBatchRecords", stats.batches * 8 >= stats.written);
+        OrderLogger::shutdown();
+
+        suite.check("logger: shutdown flushes every written record",
+                    countText(readTestFile(config.path), "\n") == stats.written);
+
+        LoggerConfig off;
+        off.path.clear();
+        OrderLogger::configure(off);
+    });
+}
@@ -0,0 +1,68 @@
+#include "test_support.h"
+
+// ==================== PAYMENT TESTS ====================
+void runPaymentTests(TestSuite& suite) {
+    suite.scenario("payment pipeline", [&]() {
+        const size_t THREADS = 2;
+        const int CALLS = 40;
+        promise<void> release;
+        shared_future<void> released = release.get_future().share();
+        atomic<int> timedOut(0);
+        atomic<int> answers(0);
+        size_t mostWorkers = 0;
+        {
+            PaymentPipeline pipeline(THREADS);
+            for (int i = 0; i < CALLS; i++) {
+                pipeline.schedule(
+                    [released](chrono::steady_clock::time_point, bool&) {
+                        released.wait();
+                        return PaymentStatus::Approved;
+                    },
+                    [&](PaymentStatus status, bool) {
+                        if (status == PaymentStatus::TimedOut) timedOut++;
+                        answers++;
+                    },
+                    chrono::steady_clock::now(), chrono::milliseconds(2));
+                this_thread::sleep_for(chrono::milliseconds(3));
+                mostWorkers = max(mostWorkers, pipeline.getWorkerCount());
+            }
+            while (answers < CALLS) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            suite.check("payments: every hung call times out once", timedOut == CALLS && answers == CALLS);
+            suite.check("payments: hung calls start at most one replacement per thread", mostWorkers <= 2 * THREADS);
+
+            release.set_value();
+            size_t workers = pipeline.getWorkerCount();
+            for (int wait = 0; wait < 1000 && workers > THREADS; wait++) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+                workers = pipeline.getWorkerCount();
+            }
+            suite.check("payments: replacements are joined once stuck calls return", workers == THREADS);
+        }
+        suite.check("payments: a late gateway answer is not reported twice", answers == CALLS);
+    });
+
+#ifdef __linux__
+    suite.scenario("checkout refunds", [&]() {
+        // Every journal write fails with ENOSPC.
+        string journal = suite.scratchFile("full.journal");
+        filesystem::create_symlink("/dev/full", journal);
+        ECommerceSystem system;
+        system.openJournal(journal);
+        vector<string> requests;
+        checkoutRequests("a", "LAP", 1, 2, requests);
+        requests.push_back("{\"op\":\"checkout\",\"session\":\"a\",\"payment\":2}");
+        requests.push_back(LIST_ORDERS);
+        requests.push_back("{\"op\":\"payment_stats\"}");
+        vector<string> results = runTestBatch(system, requests);
+        suite.check("refunds: a checkout whose order cannot be journaled is refunded",
+                    hasText(results, 1, "\"ok\":false,\"error\":\"Failed to write order journal.\",\"refunded\":true"));
+        suite.check("refunds: a retry under the same order ID charges and refunds again",
+                    hasText(results, 2, "\"refunded\":true"));
+        suite.check("refunds: no order is kept", countText(results[3], "\"order_id\":") == 0);
+        suite.check("refunds: the gateway saw both charges refunded",
+                    hasText(results, 4, "{\"id\":2,\"captured\":2,") && hasText(results, 4, "\"refunded\":2}"));
+    });
+#endif
+}
@@ -0,0 +1,56 @@
+#include "test_support.h"
+
+// ==================== PROMOTION TESTS ====================
+void runPromotionTests(TestSuite& suite) {
+    suite.scenario("promotions", [&]() {
+        suite.check("promotions: percent rounds to the nearest centavo",
+                    Money::fromCents(1999).percent(1500) == Money::fromCents(300) &&
+                    Money::fromCents(-1999).percent(1500) == Money::fromCents(-300));
+        bool overflowed = false;
+        try {
+            Money::fromCents(LLONG_MAX / 2).percent(30000);
+        } catch (const overflow_error&) {
+            overflowed = true;
+        }
+        suite.check("promotions: percent reports overflow", overflowed);
+
+        ECommerceSystem system;
+        vector<string> results = runTestBatch(system, {
+            "{\"op\":\"add_promo\",\"type\":\"percent\",\"code\":\"LAP\",\"percent\":\"10\"}",
+            "{\"op\":\"add_promo\",\"type\":\"tier\",\"code\":\"MOU\",\"min_qty\":5,\"percent\":\"20\"}",
+            "{\"op\":\"add_promo\",\"type\":\"tier\",\"code\":\"MOU\",\"min_qty\":10,\"percent\":\"30\"}",
+            "{\"op\":\"add_promo\",\"type\":\"bundle\",\"codes\":\"LAP,MOU\",\"amount\":\"100\"}",
+            "{\"op\":\"add_promo\",\"type\":\"method\",\"method\":\"GCash\",\"percent\":\"5\"}",
+            "{\"op\":\"add\",\"code\":\"LAP\",\"qty\":1}",
+            "{\"op\":\"add\",\"code\":\"MOU\",\"qty\":4}",
+            "{\"op\":\"quote\",\"payment\":1}",
+            "{\"op\":\"add\",\"code\":\"MOU\",\"qty\":2}",
+            "{\"op\":\"quote\",\"payment\":1}",
+            "{\"op\":\"quote\",\"payment\":3}",
+            "{\"op\":\"add\",\"code\":\"MOU\",\"qty\":4}",
+            "{\"op\":\"quote\",\"payment\":1}",
+            "{\"op\":\"add_promo\",\"type\":\"bundle\",\"codes\":\"LAP,MOU\",\"amount\":\"100000\"}",
+            "{\"op\":\"quote\",\"payment\":1}",
+            "{\"op\":\"remove_promo\",\"id\":6}",
+            "{\"op\":\"remove_promo\",\"id\":1}",
+            "{\"op\":\"remove_promo\",\"id\":2}",
+            "{\"op\":\"remove_promo\",\"id\":3}",
+            "{\"op\":\"remove_promo\",\"id\":4}",
+            "{\"op\":\"remove_promo\",\"id\":5}",
+            "{\"op\":\"quote\",\"payment\":3}",
+            "{\"op\":\"list_promos\"}",
+        });
+        suite.check("promotions: percent off and a bundle apply below the tier",
+                    hasText(results, 7, "\"total\":7600.00,\"subtotal\":8200.00,\"discount\":600.00,\"promotions\":[1,4]"));
+        suite.check("promotions: the first volume tier applies to the whole quantity",
+                    hasText(results, 9, "\"discount\":1560.00,\"promotions\":[1,2,4]"));
+        suite.check("promotions: a method discount applies after line discounts",
+                    hasText(results, 10, "\"total\":7828.00,\"subtotal\":9800.00,\"discount\":1972.00,\"promotions\":[1,2,4,5]"));
+        suite.check("promotions: a higher tier replaces a lower one",
+                    hasText(results, 12, "\"total\":10000.00,\"subtotal\":13000.00,\"discount\":3000.00,\"promotions\":[1,3,4]"));
+        suite.check("promotions: the discount never exceeds the subtotal", hasText(results, 14, "\"total\":0.00,"));
+        suite.check("promotions: removing every promotion restores list prices",
+                    hasText(results, 21, "\"total\":13000.00,\"subtotal\":13000.00,\"discount\":0.00,\"promotions\":[]") &&
+                    hasText(results, 22, "\"promotions\":[]"));
+    });
+}
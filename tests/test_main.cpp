@@ -0,0 +1,24 @@
+#include "test_support.h"
+
+int main() {
+    LoggerConfig config;
+    config.path.clear();
+    OrderLogger::configure(config);
+
+    int failed = 0;
+    {
+        TestSuite suite(cout);
+        runJournalTests(suite);
+        runPaymentTests(suite);
+        runPromotionTests(suite);
+        runAnalyticsTests(suite);
+        runCartTests(suite);
+        runCatalogTests(suite);
+        runCompactionTests(suite);
+        runLoggerTests(suite);
+        suite.writeSummary();
+        failed = suite.getFailed();
+    }
+    OrderLogger::shutdown();
+    return failed == 0 ? 0 : 1;
+}
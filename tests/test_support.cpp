@@ -0,0 +1,83 @@
+#include "test_support.h"
+
+// ==================== TEST SUITE ====================
+TestSuite::TestSuite(ostream& out) : out(out), passed(0), failed(0) {
+    scratch = filesystem::temp_directory_path() /
+        ("onlineStore-tests-" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+    filesystem::create_directories(scratch);
+}
+
+TestSuite::~TestSuite() {
+    error_code ignored;
+    filesystem::remove_all(scratch, ignored);
+}
+
+void TestSuite::writeSummary() const {
+    out << passed << " passed, " << failed << " failed\n";
+}
+
+vector<string> runTestBatch(ECommerceSystem& system, const vector<string>& requests) {
+    string input;
+    for (const string& request : requests) {
+        input += request + "\n";
+    }
+    istringstream in(input);
+    ostringstream out;
+    system.runBatch(in, out);
+
+    vector<string> results;
+    istringstream lines(out.str());
+    string line;
+    while (getline(lines, line)) {
+        results.push_back(line);
+    }
+    return results;
+}
+
+bool hasText(const vector<string>& results, size_t index, const string& text) {
+    return index < results.size() && results[index].find(text) != string::npos;
+}
+
+size_t countText(const string& line, const string& text) {
+    size_t count = 0;
+    for (size_t pos = line.find(text); pos != string::npos; pos = line.find(text, pos + text.size())) {
+        count++;
+    }
+    return count;
+}
+
+string readTestFile(const string& path) {
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+void writeTestFile(const string& path, const string& data) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(data.data(), static_cast<streamsize>(data.size()));
+}
+
+vector<size_t> listFrames(const string& data, size_t start) {
+    vector<size_t> frames;
+    size_t offset = start;
+    while (data.size() - offset >= 8) {
+        uint32_t length;
+        memcpy(&length, data.data() + offset, sizeof(length));
+        if (data.size() - offset - 8 < length) break;
+        frames.push_back(offset);
+        offset += 8 + length;
+    }
+    return frames;
+}
+
+void resealFrame(string& data, size_t frame) {
+    uint32_t length;
+    memcpy(&length, data.data() + frame, sizeof(length));
+    uint32_t checksum = OrderJournal::crc32(data.data() + frame + 8, length);
+    memcpy(&data[frame + 4], &checksum, sizeof(checksum));
+}
+
+void checkoutRequests(const string& session, const string& code, int quantity, int payment, vector<string>& requests) {
+    requests.push_back("{\"op\":\"add\",\"session\":\"" + session + "\",\"code\":\"" + code +
+                       "\",\"qty\":" + to_string(quantity) + "}");
+    requests.push_back("{\"op\":\"checkout\",\"session\":\"" + session + "\",\"payment\":" + to_string(payment) + "}");
+}
@@ -0,0 +1,67 @@
+#ifndef STORE_TEST_SUPPORT_H
+#define STORE_TEST_SUPPORT_H
+
+#include "store.h"
+
+// ==================== TEST SUITE ====================
+// Each scenario drives fresh ECommerceSystem instances against files in a
+// scratch directory, so restarts run the same code as a real one.
+class TestSuite {
+private:
+    ostream& out;
+    int passed;
+    int failed;
+    filesystem::path scratch;
+
+public:
+    explicit TestSuite(ostream& out);
+    ~TestSuite();
+
+    void check(const string& name, bool condition) {
+        (condition ? passed : failed)++;
+        out << (condition ? "PASS  " : "FAIL  ") << name << "\n";
+    }
+
+    // An exception fails the scenario instead of ending the run.
+    template<typename Body>
+    void scenario(const string& name, Body body) {
+        try {
+            body();
+        } catch (const exception& e) {
+            check(name + " (threw: " + e.what() + ")", false);
+        }
+    }
+
+    string scratchFile(const string& name) const { return (scratch / name).string(); }
+    int getFailed() const { return failed; }
+    void writeSummary() const;
+};
+
+const char* const LIST_ORDERS = "{\"op\":\"list_orders\"}";
+
+// Feeds requests to batch mode and returns one string per result.
+vector<string> runTestBatch(ECommerceSystem& system, const vector<string>& requests);
+
+bool hasText(const vector<string>& results, size_t index, const string& text);
+size_t countText(const string& line, const string& text);
+string readTestFile(const string& path);
+void writeTestFile(const string& path, const string& data);
+
+// Offsets of the [u32 length][u32 crc][payload] frames in data from start.
+vector<size_t> listFrames(const string& data, size_t start);
+void resealFrame(string& data, size_t frame);
+
+// Appends an add and a checkout for session.
+void checkoutRequests(const string& session, const string& code, int quantity, int payment, vector<string>& requests);
+
+// Scenarios, one file each.
+void runJournalTests(TestSuite& suite);
+void runPaymentTests(TestSuite& suite);
+void runPromotionTests(TestSuite& suite);
+void runAnalyticsTests(TestSuite& suite);
+void runCartTests(TestSuite& suite);
+void runCatalogTests(TestSuite& suite);
+void runCompactionTests(TestSuite& suite);
+void runLoggerTests(TestSuite& suite);
+
+#endif